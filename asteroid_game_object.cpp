@@ -1,12 +1,13 @@
 #include "asteroid_game_object.h"
+#include "random.h"
 
 namespace game {
     Asteroid::Asteroid(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture)
         : GameObject(position, geom, shader, texture) {
         // Generate random properties for variety
-        force_ = 2.0f + ((float)rand() / RAND_MAX) * 8.0f;  // Random bounce force between 2.0 and 10.0
+        force_ = Random::Range(RandomStream::ASTEROIDS, 2.0f, 10.0f);  // Random bounce force between 2.0 and 10.0
         SetScale(force_ * 0.8f);  // Size proportional to bounce force
-        rotation_speed_ = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;  // Random rotation speed (-1.0 to 1.0)
+        rotation_speed_ = Random::Range(RandomStream::ASTEROIDS, -1.0f, 1.0f);  // Random rotation speed (-1.0 to 1.0)
     }
 
     void Asteroid::Update(double delta_time) {
@@ -19,7 +20,7 @@ namespace game {
         SetRotation(new_angle);
     }
 
-    void Asteroid::CollisionWithPlayer(GameObject* player) {
+    void Asteroid::CollisionWithPlayer(PlayerGameObject* player) {
         if (!player || !player->IsActive()) {
             return; // Safety check
         }
@@ -53,41 +54,39 @@ namespace game {
             // First move player out of the asteroid to prevent sticking
             player_pos = asteroid_pos + push_direction * (asteroid_radius + player_radius + 0.1f);
             player->SetPosition(player_pos);
+            player->SnapTransform();
 
             // Apply bounce physics
-            PlayerGameObject* player_obj = dynamic_cast<PlayerGameObject*>(player);
-            if (player_obj) {
-                // Get player's current speed
-                float player_speed = glm::length(player_obj->GetVelocity());
+            // Get player's current speed
+            float player_speed = glm::length(player->GetVelocity());
 
-                // Base force is determined by asteroid's force property
-                float base_force = force_ * 2.0f;
+            // Base force is determined by asteroid's force property
+            float base_force = force_ * 2.0f;
 
-                // Add speed component - faster collision = stronger bounce
-                float speed_bonus = std::min(player_speed * 0.5f, 5.0f);
+            // Add speed component - faster collision = stronger bounce
+            float speed_bonus = std::min(player_speed * 0.5f, 5.0f);
 
-                // Calculate final bounce magnitude
-                float bounce_magnitude = base_force + speed_bonus;
+            // Calculate final bounce magnitude
+            float bounce_magnitude = base_force + speed_bonus;
 
-                // Create bounce force vector in the direction away from asteroid
-                glm::vec3 bounce_force = push_direction * bounce_magnitude;
+            // Create bounce force vector in the direction away from asteroid
+            glm::vec3 bounce_force = push_direction * bounce_magnitude;
 
-                // Add a small random sideways component for variety
-                glm::vec3 perpendicular(-push_direction.y, push_direction.x, 0.0f);
-                float random_factor = ((float)rand() / RAND_MAX) * 0.4f - 0.2f; // -0.2 to 0.2
-                bounce_force += perpendicular * base_force * random_factor;
+            // Add a small random sideways component for variety
+            glm::vec3 perpendicular(-push_direction.y, push_direction.x, 0.0f);
+            float random_factor = Random::Range(RandomStream::ASTEROIDS, -0.2f, 0.2f); // -0.2 to 0.2
+            bounce_force += perpendicular * base_force * random_factor;
 
-                // Debug output
-                std::cout << "Asteroid kick! Speed: " << player_speed
-                    << ", Bounce force: " << glm::length(bounce_force) << std::endl;
+            // Debug output
+            std::cout << "Asteroid kick! Speed: " << player_speed
+                << ", Bounce force: " << glm::length(bounce_force) << std::endl;
 
-                // Apply the bounce
-                player_obj->StartSliding(bounce_force);
+            // Apply the bounce
+            player->StartSliding(bounce_force);
 
-                // Lock player input briefly - longer for stronger bounces
-                float lock_time = 0.2f + (bounce_magnitude / 20.0f); // 0.2-0.7 seconds
-                player_obj->LockInputForTime(lock_time);
-            }
+            // Lock player input briefly - longer for stronger bounces
+            float lock_time = 0.2f + (bounce_magnitude / 20.0f); // 0.2-0.7 seconds
+            player->LockInputForTime(lock_time);
         }
     }
 } // namespace game
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "player_game_object.h"
 
 namespace game {
+    class PlayerGameObject;
+
     class Asteroid : public GameObject {
     public:
         // Constructor
@@ -14,7 +16,7 @@ namespace game {
         void Update(double delta_time) override;
 
         // To handle collision with player object
-        void CollisionWithPlayer(GameObject* player);
+        void CollisionWithPlayer(PlayerGameObject* player);
 
         // Getters
         float GetForce() const { return force_; }
@@ -1,27 +1,56 @@
 #include "audio_system.h"
+#include "sound_bank.h"
+#include "profiler.h"
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
 
 namespace game {
 
-    AudioSystem::AudioSystem() : device_(nullptr), context_(nullptr), bgm_source_(0) {
+    // Bound to references by std::min and std::chrono, so they need storage
+    constexpr float AudioSystem::MAX_MERGED_GAIN;
+    constexpr int AudioSystem::AUDIO_PERIOD_MS;
+
+    AudioSystem::AudioSystem() : device_(nullptr), context_(nullptr), listener_position_(0.0f), listener_moved_(false),
+        commands_(COMMAND_CAPACITY), command_write_(0), command_read_(0), music_request_fade_(0.0f), music_requested_(false),
+        stopping_(false), current_music_(0), fade_elapsed_(0.0f), fade_duration_(0.0f) {
+        for (int i = 0; i < SOUND_CATEGORY_COUNT; i++) {
+            oldest_[i] = -1;
+            newest_[i] = -1;
+        }
     }
 
     AudioSystem::~AudioSystem() {
+        // Let the audio thread finish the commands it was given, after that
+        // the voices are ours again
+        if (worker_.joinable()) {
+            stopping_.store(true, std::memory_order_release);
+            wake_.notify_one();
+            worker_.join();
+        }
+
         // Ensure we stop all sounds before cleanup
-        StopAll();
+        if (context_) {
+            StopVoices();
+        }
 
-        // Clean up sources
-        for (ALuint source : sources_) {
-            alDeleteSources(1, &source);
+        // Clean up the voice pool
+        for (Voice& voice : voices_) {
+            alDeleteSources(1, &voice.source);
         }
-        sources_.clear();
+        voices_.clear();
+        free_voices_.clear();
 
-        if (bgm_source_) {
-            alSourceStop(bgm_source_);
-            alDeleteSources(1, &bgm_source_);
-            bgm_source_ = 0;
+        for (const std::pair<const std::string, ALuint>& sound : sounds_) {
+            alDeleteBuffers(1, &sound.second);
         }
+        sounds_.clear();
+
+        // The streams need the context to free their sources
+        music_[0].Close();
+        music_[1].Close();
 
         // Clean up OpenAL context and device
         if (context_) {
@@ -52,6 +81,7 @@ namespace game {
         context_ = alcCreateContext(device_, nullptr);
         if (!context_) {
             alcCloseDevice(device_);
+            device_ = nullptr;
             throw std::runtime_error("Failed to create audio context");
         }
 
@@ -59,22 +89,46 @@ namespace game {
         if (!alcMakeContextCurrent(context_)) {
             alcDestroyContext(context_);
             alcCloseDevice(device_);
+            context_ = nullptr;
+            device_ = nullptr;
             throw std::runtime_error("Failed to make audio context current");
         }
 
-        // Create source for background music
-        alGenSources(1, &bgm_source_);
-        if (alGetError() != AL_NO_ERROR) {
-            throw std::runtime_error("Failed to create background music source");
+        // World sounds fade to silence at the edge of earshot
+        alDistanceModel(AL_LINEAR_DISTANCE_CLAMPED);
+
+        // Allocate the voice pool, drivers with fewer sources get a smaller one
+        voices_.reserve(VOICE_COUNT);
+        free_voices_.reserve(VOICE_COUNT);
+        for (int i = 0; i < VOICE_COUNT; i++) {
+            Voice voice;
+            alGenSources(1, &voice.source);
+            if (alGetError() != AL_NO_ERROR) {
+                break;
+            }
+            voice.category = SOUND_PICKUP;
+            voice.prev = -1;
+            voice.next = -1;
+            voice.active = false;
+
+            alSource3f(voice.source, AL_VELOCITY, 0.0f, 0.0f, 0.0f);
+            alSource3f(voice.source, AL_DIRECTION, 0.0f, 0.0f, 0.0f);
+            alSourcef(voice.source, AL_REFERENCE_DISTANCE, FULL_VOLUME_RADIUS);
+            alSourcef(voice.source, AL_MAX_DISTANCE, AUDIBLE_RADIUS);
+            alSourcei(voice.source, AL_LOOPING, AL_FALSE);
+            // AL_GAIN is clamped to AL_MAX_GAIN, 1 by default, which would
+            // cancel the boost of merged sounds
+            alSourcef(voice.source, AL_MAX_GAIN, MAX_MERGED_GAIN);
+
+            free_voices_.push_back(static_cast<int>(voices_.size()));
+            voices_.push_back(voice);
+        }
+        if (voices_.empty()) {
+            throw std::runtime_error("Failed to create sound effect sources");
         }
 
-        // Set up background music source properties
-        alSource3f(bgm_source_, AL_POSITION, 0.0f, 0.0f, 0.0f);
-        alSource3f(bgm_source_, AL_VELOCITY, 0.0f, 0.0f, 0.0f);
-        alSource3f(bgm_source_, AL_DIRECTION, 0.0f, 0.0f, 0.0f);
-        alSourcef(bgm_source_, AL_ROLLOFF_FACTOR, 0.0f);
-        alSourcei(bgm_source_, AL_SOURCE_RELATIVE, AL_TRUE);
-        alSourcef(bgm_source_, AL_GAIN, 0.5f); // Set volume to 50%
+        // From here on only the audio thread touches the voices and music
+        worker_ = std::thread(&AudioSystem::AudioMain, this);
     }
 
     ALuint AudioSystem::LoadSound(const std::string& filename) {
@@ -86,68 +140,400 @@ namespace game {
         return buffer;
     }
 
-    void AudioSystem::PlaySound(ALuint buffer) {
-        // Create a new source for this sound
-        ALuint source;
-        alGenSources(1, &source);
-        if (alGetError() != AL_NO_ERROR) {
+
+    void AudioSystem::LoadSoundBank(const std::string& filename) {
+        SoundBank bank;
+        bank.Open(filename);
+
+        // OpenAL copies the samples, the mapping can go right after
+        for (const SoundBank::Clip& clip : bank.GetClips()) {
+            ALuint buffer;
+            alGenBuffers(1, &buffer);
+            alBufferData(buffer, clip.format, clip.data, clip.size, clip.sample_rate);
+            if (alGetError() != AL_NO_ERROR) {
+                alDeleteBuffers(1, &buffer);
+                throw std::runtime_error("Failed to create buffer for " + clip.name + " from " + filename);
+            }
+
+            ALuint& cached = sounds_[clip.name];
+            if (cached) {
+                alDeleteBuffers(1, &cached);
+            }
+            cached = buffer;
+        }
+    }
+
+
+    ALuint AudioSystem::GetSound(const std::string& name) const {
+        std::map<std::string, ALuint>::const_iterator found = sounds_.find(SoundBank::NormalizeName(name));
+        if (found == sounds_.end()) {
+            throw std::runtime_error("Sound not in any loaded bank: " + name);
+        }
+        return found->second;
+    }
+
+    void AudioSystem::PlaySound(ALuint buffer, SoundCategory category) {
+        // Silent without a device
+        if (!context_) {
+            return;
+        }
+        QueueSound(buffer, category, false, glm::vec3(0.0f), 0.0f);
+    }
+
+
+    void AudioSystem::PlaySoundAt(ALuint buffer, SoundCategory category, const glm::vec3& position) {
+        if (!context_) {
+            return;
+        }
+
+        // Out of earshot costs nothing
+        float distance = glm::length(position - listener_position_);
+        if (distance >= AUDIBLE_RADIUS) {
+            return;
+        }
+        QueueSound(buffer, category, true, position, distance);
+    }
+
+
+    void AudioSystem::SetListenerPosition(const glm::vec3& position) {
+        listener_position_ = position;
+        listener_moved_ = true;
+    }
+
+
+    void AudioSystem::SetVolume(float gain) {
+        if (!context_) {
+            return;
+        }
+        AudioCommand command = {};
+        command.type = AudioCommand::SET_VOLUME;
+        command.gain = gain;
+        PushCommand(command);
+    }
+
+
+    void AudioSystem::QueueSound(ALuint buffer, SoundCategory category, bool positional, const glm::vec3& position, float distance) {
+        // Only a handful of different sounds play in one frame
+        for (PendingSound& pending : pending_) {
+            if (pending.buffer == buffer && pending.positional == positional) {
+                pending.count++;
+                pending.category = std::max(pending.category, category);
+                if (distance < pending.distance) {
+                    pending.position = position;
+                    pending.distance = distance;
+                }
+                return;
+            }
+        }
+
+        PendingSound sound;
+        sound.buffer = buffer;
+        sound.category = category;
+        sound.positional = positional;
+        sound.position = position;
+        sound.distance = distance;
+        sound.count = 1;
+        pending_.push_back(sound);
+    }
+
+
+    bool AudioSystem::PushCommand(const AudioCommand& command) {
+        size_t write = command_write_.load(std::memory_order_relaxed);
+        if (write - command_read_.load(std::memory_order_acquire) == COMMAND_CAPACITY) {
+            return false;
+        }
+        commands_[write % COMMAND_CAPACITY] = command;
+        command_write_.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+
+    bool AudioSystem::PopCommand(AudioCommand& command) {
+        size_t read = command_read_.load(std::memory_order_relaxed);
+        if (read == command_write_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        command = commands_[read % COMMAND_CAPACITY];
+        command_read_.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+
+    void AudioSystem::AudioMain(void) {
+        std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+        while (true) {
+            // Update() only notifies, without the lock, so a wakeup can be
+            // missed; the timeout bounds how late that makes a sound
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_.wait_for(lock, std::chrono::milliseconds(AUDIO_PERIOD_MS), [this] {
+                    return stopping_.load(std::memory_order_acquire) ||
+                        command_read_.load(std::memory_order_relaxed) != command_write_.load(std::memory_order_acquire);
+                });
+            }
+            bool stopping = stopping_.load(std::memory_order_acquire);
+
+            AudioCommand command;
+            while (PopCommand(command)) {
+                Execute(command);
+            }
+            if (stopping) {
+                return;
+            }
+
+            ReleaseFinishedVoices();
+
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            std::chrono::duration<float> elapsed = now - last;
+            last = now;
+            UpdateMusic(elapsed.count());
+        }
+    }
+
+
+    void AudioSystem::Execute(const AudioCommand& command) {
+        switch (command.type) {
+        case AudioCommand::PLAY:
+            StartSound(command);
+            break;
+        case AudioCommand::STOP_ALL:
+            StopVoices();
+            break;
+        case AudioCommand::SET_VOLUME:
+            alListenerf(AL_GAIN, command.gain);
+            break;
+        case AudioCommand::SET_LISTENER:
+            alListener3f(AL_POSITION, command.position.x, command.position.y, command.position.z);
+            break;
+        }
+    }
+
+
+    void AudioSystem::StartSound(const AudioCommand& sound) {
+        SoundCategory category = sound.category;
+        int index = AcquireVoice(category);
+        if (index < 0) {
             return;
         }
 
-        // Set up source properties
-        alSource3f(source, AL_POSITION, 0.0f, 0.0f, 0.0f);
-        alSource3f(source, AL_VELOCITY, 0.0f, 0.0f, 0.0f);
-        alSource3f(source, AL_DIRECTION, 0.0f, 0.0f, 0.0f);
-        alSourcef(source, AL_ROLLOFF_FACTOR, 0.0f);
-        alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
+        // Link the voice in as the newest of its category
+        Voice& voice = voices_[index];
+        voice.category = category;
+        voice.active = true;
+        voice.prev = newest_[category];
+        voice.next = -1;
+        if (newest_[category] >= 0) {
+            voices_[newest_[category]].next = index;
+        }
+        else {
+            oldest_[category] = index;
+        }
+        newest_[category] = index;
+
+        // Place the voice in the world, or on the listener
+        if (sound.positional) {
+            alSourcei(voice.source, AL_SOURCE_RELATIVE, AL_FALSE);
+            alSource3f(voice.source, AL_POSITION, sound.position.x, sound.position.y, sound.position.z);
+            alSourcef(voice.source, AL_ROLLOFF_FACTOR, 1.0f);
+        }
+        else {
+            alSourcei(voice.source, AL_SOURCE_RELATIVE, AL_TRUE);
+            alSource3f(voice.source, AL_POSITION, 0.0f, 0.0f, 0.0f);
+            alSourcef(voice.source, AL_ROLLOFF_FACTOR, 0.0f);
+        }
+        alSourcef(voice.source, AL_GAIN, sound.gain);
 
         // Attach buffer and play
-        alSourcei(source, AL_BUFFER, buffer);
-        alSourcei(source, AL_LOOPING, AL_FALSE);
-        alSourcePlay(source);
+        alSourcei(voice.source, AL_BUFFER, sound.buffer);
+        alSourcePlay(voice.source);
+    }
+
+
+    int AudioSystem::AcquireVoice(SoundCategory category) {
+        if (!free_voices_.empty()) {
+            int index = free_voices_.back();
+            free_voices_.pop_back();
+            return index;
+        }
+
+        // Steal the oldest voice of the lowest category that may be cut off
+        for (int c = 0; c <= category; c++) {
+            int index = oldest_[c];
+            if (index >= 0) {
+                alSourceStop(voices_[index].source);
+                ReleaseVoice(index);
+                free_voices_.pop_back();
+                return index;
+            }
+        }
+        return -1;
+    }
+
 
-        // Store source for cleanup
-        sources_.push_back(source);
+    void AudioSystem::ReleaseVoice(int index) {
+        Voice& voice = voices_[index];
+        if (voice.prev >= 0) {
+            voices_[voice.prev].next = voice.next;
+        }
+        else {
+            oldest_[voice.category] = voice.next;
+        }
+        if (voice.next >= 0) {
+            voices_[voice.next].prev = voice.prev;
+        }
+        else {
+            newest_[voice.category] = voice.prev;
+        }
+        voice.prev = -1;
+        voice.next = -1;
+        voice.active = false;
+        free_voices_.push_back(index);
     }
 
-    void AudioSystem::PlayBackgroundMusic(ALuint buffer) {
-        // Attach buffer to background music source
-        alSourcei(bgm_source_, AL_BUFFER, buffer);
-        alSourcei(bgm_source_, AL_LOOPING, AL_TRUE);
-        alSourcePlay(bgm_source_);
+
+    void AudioSystem::PlayMusic(const std::string& filename, float fade_seconds) {
+        if (!context_) {
+            return;
+        }
+
+        // Rare and carries a string, so it skips the command queue
+        std::lock_guard<std::mutex> lock(music_mutex_);
+        music_request_ = filename;
+        music_request_fade_ = fade_seconds;
+        music_requested_ = true;
     }
 
-    void AudioSystem::Update() {
-        // Remove finished sources
-        auto it = sources_.begin();
-        while (it != sources_.end()) {
-            ALint state;
-            alGetSourcei(*it, AL_SOURCE_STATE, &state);
-            if (state == AL_STOPPED) {
-                alDeleteSources(1, &(*it));
-                it = sources_.erase(it);
+
+    void AudioSystem::UpdateMusic(float delta_time) {
+        std::string filename;
+        float fade_seconds = 0.0f;
+        bool requested = false;
+        {
+            std::lock_guard<std::mutex> lock(music_mutex_);
+            if (music_requested_) {
+                filename.swap(music_request_);
+                fade_seconds = music_request_fade_;
+                requested = true;
+                music_requested_ = false;
+            }
+        }
+
+        // A track still fading out from an earlier switch is cut off
+        int next = 1 - current_music_;
+        if (requested && music_[next].Open(filename, true)) {
+            if (fade_seconds > 0.0f && music_[current_music_].IsOpen()) {
+                music_[next].SetGain(0.0f);
+                fade_elapsed_ = 0.0f;
+                fade_duration_ = fade_seconds;
             }
             else {
-                ++it;
+                music_[current_music_].Close();
+                music_[next].SetGain(MUSIC_GAIN);
+                fade_duration_ = 0.0f;
+            }
+            current_music_ = next;
+        }
+
+        // Equal-power crossfade, so the mix does not dip halfway through
+        if (fade_duration_ > 0.0f) {
+            fade_elapsed_ += delta_time;
+            float t = std::min(fade_elapsed_ / fade_duration_, 1.0f);
+            music_[current_music_].SetGain(MUSIC_GAIN * std::sin(t * 1.5707964f));
+            music_[1 - current_music_].SetGain(MUSIC_GAIN * std::cos(t * 1.5707964f));
+            if (t >= 1.0f) {
+                music_[1 - current_music_].Close();
+                fade_duration_ = 0.0f;
+            }
+        }
+
+        // Keep the music streams fed, they restart themselves if they ran dry
+        music_[0].Update();
+        music_[1].Update();
+    }
+
+
+    void AudioSystem::ReleaseFinishedVoices(void) {
+        for (int i = 0; i < static_cast<int>(voices_.size()); i++) {
+            if (!voices_[i].active) {
+                continue;
             }
+            ALint state;
+            alGetSourcei(voices_[i].source, AL_SOURCE_STATE, &state);
+            if (state == AL_STOPPED) {
+                ReleaseVoice(i);
+            }
+        }
+    }
+
+
+    void AudioSystem::Update() {
+        PROFILE_ZONE("Audio");
+
+        if (!context_) {
+            return;
         }
 
-        // Check if background music is still playing
-        ALint state;
-        alGetSourcei(bgm_source_, AL_SOURCE_STATE, &state);
-        if (state != AL_PLAYING) {
-            // Restart background music if it stopped
-            alSourcePlay(bgm_source_);
+        AudioCommand command = {};
+        if (listener_moved_) {
+            command.type = AudioCommand::SET_LISTENER;
+            command.position = listener_position_;
+            PushCommand(command);
+            listener_moved_ = false;
         }
+
+        // Hand over this frame's sounds, the most important first so that
+        // they are never the ones stolen
+        std::stable_sort(pending_.begin(), pending_.end(), [](const PendingSound& a, const PendingSound& b) {
+            return a.category > b.category;
+        });
+        command.type = AudioCommand::PLAY;
+        for (const PendingSound& sound : pending_) {
+            command.buffer = sound.buffer;
+            command.category = sound.category;
+            command.positional = sound.positional;
+            command.position = sound.position;
+            command.gain = std::min(1.0f + MERGE_GAIN_STEP * (sound.count - 1), MAX_MERGED_GAIN);
+            if (!PushCommand(command)) {
+                break;
+            }
+        }
+        pending_.clear();
+
+        wake_.notify_one();
     }
 
+
     void AudioSystem::StopAll() {
+        if (!context_) {
+            return;
+        }
+
+        // Forget the sounds and music that have not started yet
+        pending_.clear();
+        {
+            std::lock_guard<std::mutex> lock(music_mutex_);
+            music_requested_ = false;
+        }
+
+        AudioCommand command = {};
+        command.type = AudioCommand::STOP_ALL;
+        PushCommand(command);
+        wake_.notify_one();
+    }
+
+
+    void AudioSystem::StopVoices(void) {
         // Stop background music
-        alSourceStop(bgm_source_);
+        music_[0].Close();
+        music_[1].Close();
+        fade_duration_ = 0.0f;
 
         // Stop all sound effects
-        for (ALuint source : sources_) {
-            alSourceStop(source);
+        for (int i = 0; i < static_cast<int>(voices_.size()); i++) {
+            if (voices_[i].active) {
+                alSourceStop(voices_[i].source);
+                ReleaseVoice(i);
+            }
         }
     }
 
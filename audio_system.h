@@ -6,37 +6,200 @@
 #include <AL/alut.h>
 #include <string>
 #include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <glm/glm.hpp>
+
+#include "music_stream.h"
 
 namespace game {
 
+    // Kinds of sound effect, in increasing priority
+    // A full voice pool gives up its lowest priority voice for a new sound
+    enum SoundCategory {
+        SOUND_PICKUP = 0,
+        SOUND_FIRE,
+        SOUND_HIT,
+        SOUND_EXPLOSION,
+        SOUND_CATEGORY_COUNT
+    };
+
+    // Sound effects and music, mixed on a thread of their own
+    // Calls from the game thread never touch OpenAL: sounds are collected
+    // over a frame, merged, and handed over by Update() as commands in a
+    // lock-free single-producer queue. The audio thread drains the queue,
+    // owns the voice pool and the music streams, and polls for finished
+    // voices, so driver latency stays out of the frame
     class AudioSystem {
     public:
+        // Sources allocated up front for sound effects
+        static const int VOICE_COUNT = 32;
+
+        // Volume of the background music
+        static constexpr float MUSIC_GAIN = 0.5f;
+
+        // World sounds fade out linearly from FULL_VOLUME_RADIUS to
+        // AUDIBLE_RADIUS around the listener, and farther ones are skipped
+        static constexpr float FULL_VOLUME_RADIUS = 4.0f;
+        static constexpr float AUDIBLE_RADIUS = 14.0f;
+
+        // Gain added by every extra copy of a sound merged into one voice,
+        // and the most a merged voice gets
+        static constexpr float MERGE_GAIN_STEP = 0.25f;
+        static constexpr float MAX_MERGED_GAIN = 2.0f;
+
+        // Commands the game thread can have in flight, more are dropped
+        static constexpr size_t COMMAND_CAPACITY = 1024;
+
+        // Longest the audio thread sleeps between polls of its voices
+        static constexpr int AUDIO_PERIOD_MS = 5;
+
         AudioSystem();
         ~AudioSystem();
 
-        // Initialize the audio system
+        // Initialize the audio system and start the audio thread
         void Init();
 
         // Load a sound file and return its buffer ID
         ALuint LoadSound(const std::string& filename);
 
-        // Play a sound once
-        void PlaySound(ALuint buffer);
+        // Create a buffer for every clip of a sound bank, built by
+        // sound_bank_pack, in one read of the file
+        void LoadSoundBank(const std::string& filename);
+
+        // Buffer of a sound loaded from a bank, looked up by file name
+        // without regard to case; throws if no bank had it
+        ALuint GetSound(const std::string& name) const;
+
+        // Play a sound once on a pooled voice, at the listener
+        // Sounds start on the next Update(); copies of one sound requested
+        // before then share a single, louder voice
+        // When every voice is busy, the oldest voice of the lowest category
+        // not above this one is cut off; if there is none the sound is dropped
+        void PlaySound(ALuint buffer, SoundCategory category);
+
+        // Play a sound once at a point in the world, attenuated by its
+        // distance to the listener; sounds out of earshot are skipped
+        // before they take a voice, and merged copies play at the closest
+        void PlaySoundAt(ALuint buffer, SoundCategory category, const glm::vec3& position);
 
-        // Play background music (looping)
-        void PlayBackgroundMusic(ALuint buffer);
+        // Where the world is heard from, usually the player
+        void SetListenerPosition(const glm::vec3& position);
 
-		// Update the audio system (remove finished sources)
+        // Overall volume of everything
+        void SetVolume(float gain);
+
+        // Stream a music file in a loop, fading over from the current track
+        // across fade_seconds, or cutting straight to it if that is 0
+        void PlayMusic(const std::string& filename, float fade_seconds);
+
+		// Update the audio system (send the sounds requested since the last
+		// update to the audio thread), call once per frame
 		void Update();
 
         // Stop all sounds
         void StopAll();
 
     private:
+        // A pooled source, linked into the list of its category while playing
+        struct Voice {
+            ALuint source;
+            SoundCategory category;
+            int prev;   // Older voice of the same category, -1 if none
+            int next;   // Newer voice of the same category, -1 if none
+            bool active;
+        };
+
+        // A sound waiting for the next Update(), with the number of copies
+        // merged into it
+        struct PendingSound {
+            ALuint buffer;
+            SoundCategory category;
+            bool positional;
+            glm::vec3 position;
+            float distance;
+            int count;
+        };
+
+        // One request from the game thread to the audio thread
+        struct AudioCommand {
+            enum Type {
+                PLAY,           // Start buffer on a voice
+                STOP_ALL,       // Silence every voice and the music
+                SET_VOLUME,     // Overall gain
+                SET_LISTENER    // Move the listener to position
+            };
+            Type type;
+            ALuint buffer;
+            SoundCategory category;
+            bool positional;
+            glm::vec3 position;
+            float gain;
+        };
+
+        // Add a sound to the pending list, or merge it with its copy there
+        void QueueSound(ALuint buffer, SoundCategory category, bool positional, const glm::vec3& position, float distance);
+
+        // Game thread side of the command queue, false if it is full
+        bool PushCommand(const AudioCommand& command);
+
+        // Audio thread side of the command queue, false if it is empty
+        bool PopCommand(AudioCommand& command);
+
+        // Audio thread: run commands, retire voices and feed the music
+        void AudioMain(void);
+        void Execute(const AudioCommand& command);
+        void StartSound(const AudioCommand& command);
+        void ReleaseFinishedVoices(void);
+        void StopVoices(void);
+        void UpdateMusic(float delta_time);
+
+        // Take a voice from the free list, or steal one, -1 if none may be used
+        int AcquireVoice(SoundCategory category);
+
+        // Unlink a voice from its category and put it back on the free list
+        void ReleaseVoice(int index);
+
         ALCdevice* device_;
         ALCcontext* context_;
-        std::vector<ALuint> sources_;
-        ALuint bgm_source_;  // Dedicated source for background music
+
+        // Game thread only
+        std::map<std::string, ALuint> sounds_;      // Bank buffers by normalized name
+        std::vector<PendingSound> pending_;
+        glm::vec3 listener_position_;
+        bool listener_moved_;
+
+        // Commands in flight, a ring indexed by ever-growing counters
+        std::vector<AudioCommand> commands_;
+        std::atomic<size_t> command_write_;
+        std::atomic<size_t> command_read_;
+
+        // Music requested by the game thread, picked up by the audio thread
+        std::mutex music_mutex_;
+        std::string music_request_;
+        float music_request_fade_;
+        bool music_requested_;
+
+        // The audio thread, woken early by Update()
+        std::thread worker_;
+        std::mutex wake_mutex_;
+        std::condition_variable wake_;
+        std::atomic<bool> stopping_;
+
+        // Audio thread only, once it runs
+        std::vector<Voice> voices_;
+        std::vector<int> free_voices_;              // Indices of idle voices
+        int oldest_[SOUND_CATEGORY_COUNT];          // Head of each category's list
+        int newest_[SOUND_CATEGORY_COUNT];          // Tail of each category's list
+
+        // Two music streams, so one can fade in while the other fades out
+        MusicStream music_[2];
+        int current_music_;
+        float fade_elapsed_;
+        float fade_duration_;                       // 0 when no crossfade is running
 
 
     };
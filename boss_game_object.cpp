@@ -168,6 +168,20 @@ namespace game{
         GameObject::Update(delta_time);
     }
 
+    void BossGameObject::SaveTransform(void){
+        GameObject::SaveTransform();
+        base_->SaveTransform();
+        lower_arm_->SaveTransform();
+        upper_arm_->SaveTransform();
+    }
+
+    void BossGameObject::InterpolateTransform(float alpha){
+        GameObject::InterpolateTransform(alpha);
+        base_->InterpolateTransform(alpha);
+        lower_arm_->InterpolateTransform(alpha);
+        upper_arm_->InterpolateTransform(alpha);
+    }
+
     void BossGameObject::Render(glm::mat4 view_matrix, double current_time){
         if(!IsActive()){
             return;
@@ -31,6 +31,11 @@ namespace game{
             void UpdatePhase();
 
             void Render(glm::mat4 view_matrix, double current_time) override;
+            // The parts are not in the registry, so the boss interpolates them
+            void SaveTransform(void) override;
+            void InterpolateTransform(float alpha) override;
+            // Base and arms are drawn together in Render
+            bool Submit(SpriteBatch& batch) override { return false; }
 
             void FireProjectiles();
             void FireMissile();
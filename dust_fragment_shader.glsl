@@ -1,13 +1,12 @@
 #version 130
 
 // Attributes passed from the vertex shader
-in vec4 color_interp;
 in vec2 uv_interp;
+in float alpha_interp;
 
 // Uniform (global) buffer
 uniform sampler2D onetex;
 uniform float time;
-uniform float alpha;
 
 // Output fragment color
 out vec4 FragmentColor;
@@ -37,7 +36,7 @@ void main()
     float pulse = 0.85 + 0.15 * sin(time * 1.5);
     
     // Apply particle alpha with pulsating effect and falloff
-    color.a = color.a * alpha * pulse * falloff;
+    color.a = color.a * alpha_interp * pulse * falloff;
     
     // Set fragment color
     FragmentColor = color;
@@ -0,0 +1,35 @@
+// Source code of the space dust vertex shader
+#version 130
+
+// Vertex buffer (shared sprite quad)
+in vec2 vertex;
+in vec2 uv;
+
+// Particle buffer, one entry per dust particle
+in vec4 dust_motion;  // xy start position, zw velocity
+in vec2 dust_look;    // x size, y alpha
+
+// Uniform (global) buffer
+uniform mat4 view_matrix;
+uniform vec2 center;  // Center of the dust field
+uniform vec2 bounds;  // Half size of the dust field
+uniform float time;   // Seconds the field has been drifting
+
+// Attributes forwarded to the fragment shader
+out vec2 uv_interp;
+out float alpha_interp;
+
+void main()
+{
+    // Drift from the start position, wrapping around at the field's edges
+    vec2 drifted = dust_motion.xy + dust_motion.zw * time;
+    vec2 wrapped = mod(drifted + bounds, 2.0 * bounds) - bounds;
+
+    // Scale the quad to the particle size
+    vec4 vertex_pos = vec4(center + wrapped + vertex * dust_look.x, 0.0, 1.0);
+    gl_Position = view_matrix * vertex_pos;
+
+    // Pass attributes to fragment shader
+    uv_interp = uv;
+    alpha_interp = dust_look.y;
+}
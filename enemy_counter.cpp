@@ -1,4 +1,5 @@
 #include "enemy_counter.h"
+#include "render_stats.h"
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -43,10 +44,6 @@ namespace game {
 
     // Render UI method
     void EnemyCounter::RenderUI(glm::mat4 ui_projection_matrix, double current_time) {
-        // Enable blending for smooth text rendering
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
         // Safety checks
         if (!geometry_ || !shader_) {
             std::cerr << "Error: Geometry or shader not initialized for EnemyCounter" << std::endl;
@@ -63,7 +60,7 @@ namespace game {
         shader_->Enable();
 
         // Set up the UI projection matrix
-        shader_->SetUniformMat4("view_matrix", ui_projection_matrix);
+        shader_->SetUniformMat4(view_matrix_id_, ui_projection_matrix);
 
         // Setup scaling matrix (adjust scale to ensure visibility)
         glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f),
@@ -76,14 +73,16 @@ namespace game {
         glm::mat4 transformation_matrix = translation_matrix * scaling_matrix;
 
         // Set transformation matrix
-        shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-        shader_->SetUniform1i("ghost_mode", 0);
+        shader_->SetUniformMat4(transformation_matrix_id_, transformation_matrix);
+        shader_->SetUniform1i(ghost_mode_id_, 0);
 
         // Prepare geometry
         geometry_->SetGeometry(shader_->GetShaderProgram());
+        RenderState::Overlay().Apply();
 
         // Bind font texture
         glBindTexture(GL_TEXTURE_2D, texture_);
+        RenderStats::CountTextureBind();
 
         // Prepare text rendering parameters
 #define TEXT_LENGTH 40
@@ -91,21 +90,21 @@ namespace game {
         if (final_size > TEXT_LENGTH) {
             final_size = TEXT_LENGTH;
         }
-        shader_->SetUniform1i("text_len", final_size);
+        shader_->SetUniform1i(text_len_id_, final_size);
 
         // Convert text to integer array for shader
         GLint text_data[TEXT_LENGTH];
         for (int i = 0; i < final_size; i++) {
             text_data[i] = text[i];
         }
-        shader_->SetUniformIntArray("text_content", final_size, text_data);
+        shader_->SetUniformIntArray(text_content_id_, final_size, text_data);
 
         // Draw text
         glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+        RenderStats::CountDraw();
 
         // Clean up
         shader_->Disable();
-        glDisable(GL_BLEND);
     }
 
 } // namespace game
\ No newline at end of file
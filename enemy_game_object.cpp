@@ -5,7 +5,8 @@
 namespace game {
 
     EnemyGameObject::EnemyGameObject(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture)
-        : GameObject(position, geom, shader, texture) {
+        : GameObject(position, geom, shader, texture),
+        rng_(Random::Next(RandomStream::ENEMY_AI)) {
         // Initialize enemy-specific variables
         state_ = EnemyState::PATROLLING;
         patrol_center_ = position;
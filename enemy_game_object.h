@@ -3,6 +3,7 @@
 
 #include "game_object.h"
 #include "timer.h"
+#include "random.h"
 
 namespace game {
 
@@ -97,6 +98,9 @@ namespace game {
         Timer course_correction_timer_;     // Timer for updating course
         Timer attack_cooldown_timer_;       // Timer for attack cooldown
 
+        // Movement choices, enemies update in parallel so each has its own
+        LocalRandom rng_;
+
         // Helper functions
         void UpdatePatrolMovement(double delta_time);
         void UpdateInterceptionMovement(double delta_time);
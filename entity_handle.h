@@ -0,0 +1,46 @@
+#ifndef ENTITY_HANDLE_H_
+#define ENTITY_HANDLE_H_
+
+#include <cstdint>
+
+namespace game {
+
+    // The kind of pool an entity lives in
+    enum class EntityKind : uint8_t {
+        PLAYER,
+        ENEMY,
+        PROJECTILE,
+        HOMING_MISSILE,
+        COLLECTIBLE,
+        ASTEROID,
+        UI_TEXT,
+        BOSS,
+        EFFECT,
+        KIND_COUNT
+    };
+
+    // A generational reference to an entity in the EntityRegistry
+    // A handle goes stale (resolves to nullptr) once its entity is removed,
+    // even if the slot is later reused by a new entity
+    struct EntityHandle {
+        static const uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+        uint32_t index;
+        uint32_t generation;
+        EntityKind kind;
+
+        EntityHandle(void) : index(INVALID_INDEX), generation(0), kind(EntityKind::KIND_COUNT) {}
+        EntityHandle(EntityKind k, uint32_t i, uint32_t g) : index(i), generation(g), kind(k) {}
+
+        // True if the handle was ever assigned (it may still be stale)
+        inline bool IsSet(void) const { return index != INVALID_INDEX; }
+
+        inline bool operator==(const EntityHandle& other) const {
+            return index == other.index && generation == other.generation && kind == other.kind;
+        }
+        inline bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+    };
+
+} // namespace game
+
+#endif // ENTITY_HANDLE_H_
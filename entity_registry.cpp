@@ -0,0 +1,76 @@
+#include "entity_registry.h"
+
+namespace game {
+
+    EntityRegistry::EntityRegistry(void)
+        : players_(EntityKind::PLAYER),
+        enemies_(EntityKind::ENEMY),
+        projectiles_(EntityKind::PROJECTILE),
+        homing_missiles_(EntityKind::HOMING_MISSILE),
+        collectibles_(EntityKind::COLLECTIBLE),
+        asteroids_(EntityKind::ASTEROID),
+        texts_(EntityKind::UI_TEXT),
+        bosses_(EntityKind::BOSS),
+        effects_(EntityKind::EFFECT) {
+
+        // Shots are spawned and removed constantly, keep them off the heap
+        projectiles_.Reserve(PROJECTILE_CAPACITY);
+        homing_missiles_.Reserve(HOMING_MISSILE_CAPACITY);
+    }
+
+    GameObject* EntityRegistry::Get(EntityHandle handle) const {
+        switch (handle.kind) {
+        case EntityKind::PLAYER: return players_.Get(handle);
+        case EntityKind::ENEMY: return enemies_.Get(handle);
+        case EntityKind::PROJECTILE: return projectiles_.Get(handle);
+        case EntityKind::HOMING_MISSILE: return homing_missiles_.Get(handle);
+        case EntityKind::COLLECTIBLE: return collectibles_.Get(handle);
+        case EntityKind::ASTEROID: return asteroids_.Get(handle);
+        case EntityKind::UI_TEXT: return texts_.Get(handle);
+        case EntityKind::BOSS: return bosses_.Get(handle);
+        case EntityKind::EFFECT: return effects_.Get(handle);
+        default: return nullptr;
+        }
+    }
+
+    size_t EntityRegistry::Count(void) const {
+        return players_.Size() + enemies_.Size() + projectiles_.Size() +
+            homing_missiles_.Size() + collectibles_.Size() + asteroids_.Size() +
+            texts_.Size() + bosses_.Size() + effects_.Size();
+    }
+
+    void EntityRegistry::Clear(void) {
+        homing_missiles_.Clear();
+        projectiles_.Clear();
+        enemies_.Clear();
+        bosses_.Clear();
+        collectibles_.Clear();
+        asteroids_.Clear();
+        texts_.Clear();
+        effects_.Clear();
+        players_.Clear();
+    }
+
+    template <typename T>
+    static void PrintPoolStats(std::ostream& out, const char* name, const EntityPool<T>& pool) {
+        out << "  " << name << ": " << pool.Size() << " live, " << pool.GetHighWater() << " peak";
+        if (pool.GetCapacity() > 0) {
+            out << ", capacity " << pool.GetCapacity() << ", " << pool.GetOverflowCount() << " overflowed";
+        }
+        out << std::endl;
+    }
+
+    void EntityRegistry::PrintStats(std::ostream& out) const {
+        out << "Entity pools:" << std::endl;
+        PrintPoolStats(out, "players", players_);
+        PrintPoolStats(out, "enemies", enemies_);
+        PrintPoolStats(out, "projectiles", projectiles_);
+        PrintPoolStats(out, "homing missiles", homing_missiles_);
+        PrintPoolStats(out, "collectibles", collectibles_);
+        PrintPoolStats(out, "asteroids", asteroids_);
+        PrintPoolStats(out, "texts", texts_);
+        PrintPoolStats(out, "bosses", bosses_);
+        PrintPoolStats(out, "effects", effects_);
+    }
+
+} // namespace game
@@ -0,0 +1,291 @@
+#ifndef ENTITY_REGISTRY_H_
+#define ENTITY_REGISTRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <ostream>
+
+#include "entity_handle.h"
+#include "game_object.h"
+#include "player_game_object.h"
+#include "enemy_game_object.h"
+#include "projectile_game_object.h"
+#include "homing_missile.h"
+#include "collectible_game_object.h"
+#include "asteroid_game_object.h"
+#include "text_game_object.h"
+#include "boss_game_object.h"
+
+namespace game {
+
+    // A densely packed pool of objects of one kind
+    // Objects are owned by the pool and deleted when removed
+    // Removal swaps the last object into the freed spot, so iteration order is not stable
+    // A pool given a capacity with Reserve() also owns fixed storage for that
+    // many objects of exactly type T; Create() builds objects there from a free
+    // list, so frequently spawned kinds never touch the heap
+    template <typename T>
+    class EntityPool {
+    public:
+        explicit EntityPool(EntityKind kind) : kind_(kind), capacity_(0), high_water_(0), overflow_(0) {}
+        ~EntityPool() { Clear(); }
+
+        EntityPool(const EntityPool&) = delete;
+        EntityPool& operator=(const EntityPool&) = delete;
+
+        // Allocate storage for capacity objects built by Create(), call while empty
+        void Reserve(size_t capacity) {
+            if (!dense_.empty()) {
+                return;
+            }
+            storage_.reset(capacity ? new Storage[capacity] : nullptr);
+            capacity_ = capacity;
+            free_storage_.clear();
+            for (size_t i = capacity; i > 0; i--) {
+                free_storage_.push_back(static_cast<uint32_t>(i - 1));
+            }
+        }
+
+        // Build an object in the pool's storage, falling back to the heap when
+        // it is full; hand the object to Add() to make it live
+        template <typename... Args>
+        T* Create(Args&&... args) {
+            if (free_storage_.empty()) {
+                if (capacity_ > 0) {
+                    overflow_++;
+                }
+                return new T(std::forward<Args>(args)...);
+            }
+            uint32_t cell = free_storage_.back();
+            T* object = new (&storage_[cell]) T(std::forward<Args>(args)...);
+            free_storage_.pop_back();
+            return object;
+        }
+
+        // Take ownership of an object and return a handle to it
+        // Call once its spawn transform is set, it is drawn from there
+        EntityHandle Add(T* object) {
+            uint32_t slot;
+            if (!free_slots_.empty()) {
+                slot = free_slots_.back();
+                free_slots_.pop_back();
+            }
+            else {
+                slot = static_cast<uint32_t>(slots_.size());
+                slots_.push_back(Slot());
+            }
+
+            slots_[slot].dense_index = static_cast<uint32_t>(dense_.size());
+            slots_[slot].alive = true;
+            object->SetKind(kind_);
+            object->SnapTransform();
+            dense_.push_back(object);
+            dense_slots_.push_back(slot);
+            if (dense_.size() > high_water_) {
+                high_water_ = dense_.size();
+            }
+
+            return EntityHandle(kind_, slot, slots_[slot].generation);
+        }
+
+        // Resolve a handle, returns nullptr if it is stale or of another kind
+        T* Get(EntityHandle handle) const {
+            if (handle.kind != kind_ || handle.index >= slots_.size()) {
+                return nullptr;
+            }
+            const Slot& slot = slots_[handle.index];
+            if (!slot.alive || slot.generation != handle.generation) {
+                return nullptr;
+            }
+            return dense_[slot.dense_index];
+        }
+
+        // Handle of the object stored at a dense index
+        EntityHandle HandleAt(size_t i) const {
+            uint32_t slot = dense_slots_[i];
+            return EntityHandle(kind_, slot, slots_[slot].generation);
+        }
+
+        // Delete the object at a dense index (swap-and-pop)
+        void RemoveAt(size_t i) {
+            uint32_t slot = dense_slots_[i];
+            Destroy(dense_[i]);
+
+            size_t last = dense_.size() - 1;
+            if (i != last) {
+                dense_[i] = dense_[last];
+                dense_slots_[i] = dense_slots_[last];
+                slots_[dense_slots_[i]].dense_index = static_cast<uint32_t>(i);
+            }
+            dense_.pop_back();
+            dense_slots_.pop_back();
+
+            // Bumping the generation invalidates every outstanding handle
+            slots_[slot].alive = false;
+            slots_[slot].generation++;
+            free_slots_.push_back(slot);
+        }
+
+        // Delete the object a handle refers to, returns false if the handle is stale
+        bool Remove(EntityHandle handle) {
+            if (!Get(handle)) {
+                return false;
+            }
+            RemoveAt(slots_[handle.index].dense_index);
+            return true;
+        }
+
+        // Delete every inactive object, on_remove(T*) is called just before deletion
+        template <typename Callback>
+        void RemoveInactive(Callback on_remove) {
+            for (size_t i = 0; i < dense_.size();) {
+                if (!dense_[i]->IsActive()) {
+                    on_remove(dense_[i]);
+                    RemoveAt(i);
+                }
+                else {
+                    i++;
+                }
+            }
+        }
+
+        void RemoveInactive(void) {
+            RemoveInactive([](T*) {});
+        }
+
+        // Delete every object
+        void Clear(void) {
+            while (!dense_.empty()) {
+                RemoveAt(dense_.size() - 1);
+            }
+        }
+
+        // Dense access, valid indices are [0, Size())
+        inline size_t Size(void) const { return dense_.size(); }
+        inline bool Empty(void) const { return dense_.empty(); }
+        inline T* operator[](size_t i) const { return dense_[i]; }
+
+        // Range-for support; do not add or remove while iterating this way
+        inline typename std::vector<T*>::const_iterator begin(void) const { return dense_.begin(); }
+        inline typename std::vector<T*>::const_iterator end(void) const { return dense_.end(); }
+
+        inline EntityKind GetKind(void) const { return kind_; }
+
+        // Statistics
+        // High water is the most objects alive at once, overflow counts
+        // Create() calls that found the fixed storage full
+        inline size_t GetCapacity(void) const { return capacity_; }
+        inline size_t GetHighWater(void) const { return high_water_; }
+        inline size_t GetOverflowCount(void) const { return overflow_; }
+
+    private:
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+        // Destroy an object, returning its cell if it lives in the fixed storage
+        void Destroy(T* object) {
+            const Storage* cell = reinterpret_cast<const Storage*>(object);
+            if (capacity_ > 0 && cell >= &storage_[0] && cell < &storage_[0] + capacity_) {
+                object->~T();
+                free_storage_.push_back(static_cast<uint32_t>(cell - &storage_[0]));
+            }
+            else {
+                delete object;
+            }
+        }
+
+        struct Slot {
+            uint32_t generation = 0;
+            uint32_t dense_index = 0;
+            bool alive = false;
+        };
+
+        EntityKind kind_;
+        std::vector<T*> dense_;                // Packed objects
+        std::vector<uint32_t> dense_slots_;    // Slot owning each packed object
+        std::vector<Slot> slots_;              // Sparse slots addressed by handles
+        std::vector<uint32_t> free_slots_;     // Recycled slots
+
+        std::unique_ptr<Storage[]> storage_;   // Fixed storage for Create()
+        std::vector<uint32_t> free_storage_;   // Unused storage cells
+        size_t capacity_;
+        size_t high_water_;
+        size_t overflow_;
+    };
+
+    // Owns every entity in the game world, one pool per kind
+    class EntityRegistry {
+    public:
+        // Fixed storage for the kinds spawned every few frames
+        static const size_t PROJECTILE_CAPACITY = 512;
+        static const size_t HOMING_MISSILE_CAPACITY = 64;
+
+        EntityRegistry(void);
+
+        // Per-kind pools
+        inline EntityPool<PlayerGameObject>& Players(void) { return players_; }
+        inline EntityPool<EnemyGameObject>& Enemies(void) { return enemies_; }
+        inline EntityPool<Projectile>& Projectiles(void) { return projectiles_; }
+        inline EntityPool<HomingMissile>& HomingMissiles(void) { return homing_missiles_; }
+        inline EntityPool<CollectibleGameObject>& Collectibles(void) { return collectibles_; }
+        inline EntityPool<Asteroid>& Asteroids(void) { return asteroids_; }
+        inline EntityPool<TextGameObject>& Texts(void) { return texts_; }
+        inline EntityPool<BossGameObject>& Bosses(void) { return bosses_; }
+        inline EntityPool<GameObject>& Effects(void) { return effects_; }
+
+        inline const EntityPool<PlayerGameObject>& Players(void) const { return players_; }
+        inline const EntityPool<EnemyGameObject>& Enemies(void) const { return enemies_; }
+        inline const EntityPool<Projectile>& Projectiles(void) const { return projectiles_; }
+        inline const EntityPool<HomingMissile>& HomingMissiles(void) const { return homing_missiles_; }
+        inline const EntityPool<CollectibleGameObject>& Collectibles(void) const { return collectibles_; }
+        inline const EntityPool<Asteroid>& Asteroids(void) const { return asteroids_; }
+        inline const EntityPool<TextGameObject>& Texts(void) const { return texts_; }
+        inline const EntityPool<BossGameObject>& Bosses(void) const { return bosses_; }
+        inline const EntityPool<GameObject>& Effects(void) const { return effects_; }
+
+        // Resolve a handle of any kind, returns nullptr if it is stale
+        GameObject* Get(EntityHandle handle) const;
+
+        // Call fn(GameObject*) for every entity, in render order
+        template <typename Fn>
+        void ForEach(Fn fn) const {
+            for (auto obj : players_) fn(obj);
+            for (auto obj : texts_) fn(obj);
+            for (auto obj : effects_) fn(obj);
+            for (auto obj : asteroids_) fn(obj);
+            for (auto obj : collectibles_) fn(obj);
+            for (auto obj : enemies_) fn(obj);
+            for (auto obj : bosses_) fn(obj);
+            for (auto obj : projectiles_) fn(obj);
+            for (auto obj : homing_missiles_) fn(obj);
+        }
+
+        // Total number of live entities
+        size_t Count(void) const;
+
+        // Delete every entity
+        void Clear(void);
+
+        // Print the size statistics of every pool
+        void PrintStats(std::ostream& out) const;
+
+    private:
+        EntityPool<PlayerGameObject> players_;
+        EntityPool<EnemyGameObject> enemies_;
+        EntityPool<Projectile> projectiles_;
+        EntityPool<HomingMissile> homing_missiles_;
+        EntityPool<CollectibleGameObject> collectibles_;
+        EntityPool<Asteroid> asteroids_;
+        EntityPool<TextGameObject> texts_;
+        EntityPool<BossGameObject> bosses_;
+        EntityPool<GameObject> effects_;
+
+    }; // class EntityRegistry
+
+} // namespace game
+
+#endif // ENTITY_REGISTRY_H_
@@ -1,5 +1,6 @@
 // fast_enemy_game_object.cpp
 #include "fast_enemy_game_object.h"
+#include "random.h"
 #include <iostream>
 #include <glm/gtc/constants.hpp>
 
@@ -31,7 +32,7 @@ namespace game {
             // Switch strafe direction
             strafe_direction_ = !strafe_direction_;
             // Randomize next strafe time between 0.8 and 1.2 seconds
-            float next_strafe = 0.8f + static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 0.4f;
+            float next_strafe = rng_.Range(0.8f, 1.2f);
             strafe_timer_.Start(next_strafe);
         }
 
@@ -116,9 +117,8 @@ namespace game {
 
         // Check if we can attack - only fire within reasonable range
         if (CanAttack() && distance_to_target < optimal_distance * 1.5f) {
-            if (FireProjectile()) {
-                std::cout << "Fast enemy firing!" << std::endl;
-            }
+            // Only restarts the cooldown, the shot itself is fired by Game
+            FireProjectile();
         }
     }
 } // namespace game
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include "flame_emitter.h"
+#include "render_stats.h"
+#include "entity_registry.h"
+#include "random.h"
+
+namespace game {
+
+    FlameEmitter::FlameEmitter(int capacity)
+        : capacity_(capacity), head_(0), live_particles_(0), high_water_(0), overflow_(0),
+        offset_x_(capacity), offset_y_(capacity),
+        velocity_x_(capacity), velocity_y_(capacity),
+        size_(capacity), age_(capacity, 1.0f), lifetime_(capacity, 1.0f),
+        source_(capacity, 0), render_state_(RenderState::Additive()) {
+
+        source_count_ = 0;
+        registry_ = nullptr;
+        geometry_ = nullptr;
+        shader_ = nullptr;
+        texture_ = 0;
+        vao_ = 0;
+        instance_vbo_ = 0;
+
+        // Initialize distributions
+        dist_lifetime_ = std::uniform_real_distribution<float>(0.1f, 0.3f);
+        dist_offset_ = std::uniform_real_distribution<float>(-0.1f, 0.1f);
+        dist_size_ = std::uniform_real_distribution<float>(0.05f, 0.15f);
+        dist_speed_ = std::uniform_real_distribution<float>(1.0f, 2.5f);
+
+        instances_.reserve(capacity);
+    }
+
+
+    FlameEmitter::~FlameEmitter() {
+        if (instance_vbo_) {
+            glDeleteBuffers(1, &instance_vbo_);
+        }
+        if (vao_) {
+            glDeleteVertexArrays(1, &vao_);
+        }
+    }
+
+
+    void FlameEmitter::Init(Geometry* geom, Shader* shader, GLuint texture, const EntityRegistry* registry) {
+        if (!geom || !shader || !registry) {
+            throw std::runtime_error("Invalid geometry, shader or registry in FlameEmitter::Init");
+        }
+        geometry_ = geom;
+        shader_ = shader;
+        view_matrix_id_ = shader->GetUniformId("view_matrix");
+        time_id_ = shader->GetUniformId("time");
+        texture_ = texture;
+        registry_ = registry;
+
+        // Seeded here rather than at construction, once the match seed is set
+        rng_ = std::mt19937(Random::Next(RandomStream::EFFECTS));
+
+        // Room for every particle in the ring, refilled each frame
+        glGenBuffers(1, &instance_vbo_);
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+        glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+
+        // The quad comes from the shared geometry, the particle attributes
+        // advance once per instance
+        glGenVertexArrays(1, &vao_);
+        glBindVertexArray(vao_);
+        geometry_->SetupAttributes();
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+        glVertexAttribPointer(ATTRIB_INSTANCE_0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), 0);
+        glVertexAttribPointer(ATTRIB_INSTANCE_1, 1, GL_FLOAT, GL_FALSE, sizeof(Instance),
+            (void*)sizeof(glm::vec4));
+        glEnableVertexAttribArray(ATTRIB_INSTANCE_0);
+        glEnableVertexAttribArray(ATTRIB_INSTANCE_1);
+        glVertexAttribDivisor(ATTRIB_INSTANCE_0, 1);
+        glVertexAttribDivisor(ATTRIB_INSTANCE_1, 1);
+        glBindVertexArray(0);
+    }
+
+
+    void FlameEmitter::AddSource(EntityHandle missile) {
+        GameObject* parent = registry_ ? registry_->Get(missile) : nullptr;
+        if (!parent) {
+            return;
+        }
+
+        uint32_t slot;
+        if (!free_sources_.empty()) {
+            slot = free_sources_.back();
+            free_sources_.pop_back();
+        }
+        else {
+            slot = static_cast<uint32_t>(sources_.size());
+            sources_.push_back(Source());
+        }
+
+        Source& source = sources_[slot];
+        source.missile = missile;
+        glm::vec3 position = parent->GetPosition();
+        source.position = glm::vec2(position.x, position.y);
+        source.rotation = parent->GetRotation();
+        source.emit_budget = 0.0f;
+        source.alive = true;
+        source_count_++;
+
+        // Start with a full flame, with staggered ages so the particles
+        // don't all expire at once
+        for (int i = 0; i < PARTICLES_PER_SOURCE; i++) {
+            Emit(slot, dist_lifetime_(rng_) * 0.8f);
+        }
+    }
+
+
+    void FlameEmitter::Emit(uint32_t source, float age) {
+        uint32_t i = head_;
+        head_ = (head_ + 1) % capacity_;
+        if (age_[i] < lifetime_[i]) {
+            overflow_++;
+        }
+        else {
+            live_particles_++;
+        }
+
+        lifetime_[i] = dist_lifetime_(rng_);
+        age_[i] = age;
+        source_[i] = source;
+
+        // Start at the back of the missile
+        // Since the missile texture points right, the back is at negative x
+        offset_x_[i] = -0.25f;
+        offset_y_[i] = dist_offset_(rng_) * 0.1f;
+
+        // Move away from the back
+        velocity_x_[i] = -dist_speed_(rng_);
+        velocity_y_[i] = dist_offset_(rng_) * 0.3f;
+
+        size_[i] = dist_size_(rng_);
+    }
+
+
+    void FlameEmitter::Clear(void) {
+        sources_.clear();
+        free_sources_.clear();
+        source_count_ = 0;
+
+        std::fill(age_.begin(), age_.end(), 1.0f);
+        std::fill(lifetime_.begin(), lifetime_.end(), 1.0f);
+        head_ = 0;
+        live_particles_ = 0;
+        instances_.clear();
+    }
+
+
+    void FlameEmitter::Update(double delta_time) {
+        float dt = static_cast<float>(delta_time);
+
+        // Keep the old per-missile density: a source replaces its particles
+        // as fast as they expire on average
+        float mean_lifetime = 0.5f * (dist_lifetime_.a() + dist_lifetime_.b());
+        float emit_rate = PARTICLES_PER_SOURCE / mean_lifetime;
+
+        // Follow the missiles, retire the ones that are gone, emit for the rest
+        for (uint32_t s = 0; s < sources_.size(); s++) {
+            Source& source = sources_[s];
+            if (!source.alive) {
+                continue;
+            }
+
+            GameObject* parent = registry_->Get(source.missile);
+            if (!parent || !parent->IsActive()) {
+                source.alive = false;
+                free_sources_.push_back(s);
+                source_count_--;
+                continue;
+            }
+
+            source.emit_budget += emit_rate * dt;
+            while (source.emit_budget >= 1.0f) {
+                Emit(s, 0.0f);
+                source.emit_budget -= 1.0f;
+            }
+        }
+
+        if (live_particles_ > high_water_) {
+            high_water_ = live_particles_;
+        }
+
+        // With no missiles in flight the ring empties and stays empty; dead
+        // slots are rewritten in full by Emit(), so they need no upkeep
+        if (live_particles_ == 0) {
+            return;
+        }
+
+        // Particles of a retired source die with it, before its slot is reused
+        for (int i = 0; i < capacity_; i++) {
+            if (age_[i] < lifetime_[i] && !sources_[source_[i]].alive) {
+                age_[i] = lifetime_[i];
+            }
+        }
+
+        // Advance every slot, live or not, in one branch-free pass
+        int live = 0;
+        for (int i = 0; i < capacity_; i++) {
+            age_[i] += dt;
+            offset_x_[i] += velocity_x_[i] * dt;
+            offset_y_[i] += velocity_y_[i] * dt;
+
+            // Shrink over time
+            float life_factor = age_[i] / lifetime_[i];
+            size_[i] *= (1.0f - life_factor * 0.1f);
+            live += age_[i] < lifetime_[i];
+        }
+        live_particles_ = live;
+    }
+
+
+    void FlameEmitter::PackInstances(void) {
+        // Place each flame where its missile is drawn this frame
+        for (Source& source : sources_) {
+            GameObject* parent = source.alive ? registry_->Get(source.missile) : nullptr;
+            if (parent) {
+                glm::vec3 position = parent->GetRenderPosition();
+                source.position = glm::vec2(position.x, position.y);
+                source.rotation = parent->GetRenderRotation();
+            }
+        }
+
+        // Pack the live particles in world space
+        instances_.clear();
+        if (live_particles_ == 0) {
+            return;
+        }
+        for (int i = 0; i < capacity_; i++) {
+            if (age_[i] >= lifetime_[i]) {
+                continue;
+            }
+
+            // Fade out over the lifetime, skipping nearly transparent particles
+            float alpha = 0.8f * (1.0f - age_[i] / lifetime_[i]);
+            if (alpha < 0.05f) {
+                continue;
+            }
+
+            // Transform the offset to world space based on missile orientation
+            const Source& source = sources_[source_[i]];
+            float c = std::cos(source.rotation);
+            float s = std::sin(source.rotation);
+            glm::vec2 world_pos = source.position +
+                glm::vec2(c * offset_x_[i] - s * offset_y_[i], s * offset_x_[i] + c * offset_y_[i]);
+
+            Instance instance;
+            instance.transform = glm::vec4(world_pos.x, world_pos.y, source.rotation, size_[i]);
+            instance.alpha = alpha;
+            instances_.push_back(instance);
+        }
+    }
+
+
+    void FlameEmitter::Render(const glm::mat4& view_matrix, double current_time) {
+        if (!shader_) {
+            return;
+        }
+        PackInstances();
+        if (instances_.empty()) {
+            return;
+        }
+        RenderPassScope pass(RenderPass::FLAMES);
+
+        // Setup shader and blending
+        shader_->Enable();
+        render_state_.Apply();
+
+        // Set view matrix and time for the glow animation
+        shader_->SetUniformMat4(view_matrix_id_, view_matrix);
+        shader_->SetUniform1f(time_id_, static_cast<float>(current_time));
+
+        // Bind flame texture
+        glBindTexture(GL_TEXTURE_2D, texture_);
+        RenderStats::CountTextureBind();
+
+        // Orphan and refill the instance buffer
+        glBindVertexArray(vao_);
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+        glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instances_.size() * sizeof(Instance), instances_.data());
+
+        // Draw every flame at once
+        glDrawElementsInstanced(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0,
+            static_cast<GLsizei>(instances_.size()));
+        RenderStats::CountDraw();
+
+        // Cleanup
+        shader_->Disable();
+    }
+
+} // namespace game
@@ -0,0 +1,131 @@
+#ifndef FLAME_EMITTER_H_
+#define FLAME_EMITTER_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "shader.h"
+#include "geometry.h"
+#include "render_state.h"
+#include "entity_handle.h"
+
+namespace game {
+
+    class EntityRegistry;
+
+    // The exhaust flames of every missile, simulated and drawn together
+    // Missiles register as sources; the emitter owns a fixed ring of particles
+    // shared by all sources, so spawning a flame allocates nothing and the
+    // whole set draws with one instanced call
+    // Particles are stored relative to their source and follow it, a source
+    // and its particles go away once its missile is removed from the registry
+    class FlameEmitter {
+
+    public:
+        FlameEmitter(int capacity = 4096);
+        ~FlameEmitter();
+
+        // Create the instance buffer, call once the GL context exists
+        // geom is the sprite quad, shader is the flame particle shader
+        void Init(Geometry* geom, Shader* shader, GLuint texture, const EntityRegistry* registry);
+
+        // Start a flame behind a missile
+        void AddSource(EntityHandle missile);
+
+        // Remove every source and particle
+        void Clear(void);
+
+        // Retire finished sources, emit and advance every particle
+        void Update(double delta_time);
+
+        // Draw every live particle behind its missile's interpolated transform
+        void Render(const glm::mat4& view_matrix, double current_time);
+
+        // False until Init(), runs without a GL context never simulate flames
+        inline bool IsInitialized(void) const { return registry_ != nullptr; }
+
+        // Statistics
+        inline int GetSourceCount(void) const { return source_count_; }
+        // Particles drawn in the last frame
+        inline int GetLiveCount(void) const { return static_cast<int>(instances_.size()); }
+        inline int GetCapacity(void) const { return capacity_; }
+        // Most ring slots in use at once, after a step's emission
+        inline int GetHighWater(void) const { return high_water_; }
+        // Particles overwritten by the ring before they expired
+        inline int GetOverflowCount(void) const { return overflow_; }
+
+    private:
+        // Particles a source keeps alive on average, as the old per-missile flame did
+        static const int PARTICLES_PER_SOURCE = 40;
+
+        // A registered missile
+        struct Source {
+            EntityHandle missile;
+            glm::vec2 position;
+            float rotation;
+            float emit_budget;  // Fractional particles owed to the ring
+            bool alive;
+        };
+
+        // Per-instance data, must match the instance attributes of the shader
+        struct Instance {
+            glm::vec4 transform;  // xy position, z rotation angle, w size
+            float alpha;
+        };
+
+        // Write one particle for a source into the ring, overwriting the oldest
+        void Emit(uint32_t source, float age);
+
+        // Gather the live particles in world space for drawing
+        void PackInstances(void);
+
+        int capacity_;
+        uint32_t head_;                 // Next ring slot to write
+        int live_particles_;            // Ring slots with age < lifetime
+        int high_water_;
+        int overflow_;
+
+        // Particle ring, structure of arrays
+        // A slot is live while age < lifetime and its source is alive
+        std::vector<float> offset_x_;   // Offset from the source, in its frame
+        std::vector<float> offset_y_;
+        std::vector<float> velocity_x_; // Velocity in the source's frame
+        std::vector<float> velocity_y_;
+        std::vector<float> size_;
+        std::vector<float> age_;
+        std::vector<float> lifetime_;
+        std::vector<uint32_t> source_;
+
+        std::vector<Source> sources_;
+        std::vector<uint32_t> free_sources_;
+        int source_count_;
+
+        // Live particles packed for upload, rebuilt every frame
+        std::vector<Instance> instances_;
+
+        const EntityRegistry* registry_;
+        Geometry* geometry_;
+        Shader* shader_;
+        UniformId view_matrix_id_;
+        UniformId time_id_;
+        GLuint texture_;
+        GLuint vao_;                    // Quad attributes plus instance attributes
+        GLuint instance_vbo_;
+        RenderState render_state_;       // Additive blending for glow effect
+
+        // One generator for every flame
+        std::mt19937 rng_;
+        std::uniform_real_distribution<float> dist_lifetime_;
+        std::uniform_real_distribution<float> dist_offset_;
+        std::uniform_real_distribution<float> dist_size_;
+        std::uniform_real_distribution<float> dist_speed_;
+
+    }; // class FlameEmitter
+
+} // namespace game
+
+#endif // FLAME_EMITTER_H_
@@ -1,9 +1,12 @@
 #include <ctime>
 #include <stdexcept>
 #include <string>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp> 
-#include <SOIL/SOIL.h>
 #include <iostream>
 
 #include <path_config.h>
@@ -16,6 +19,12 @@
 #include "game_timer.h"    
 #include <ctime>
 #include "space_dust.h"
+#include "game_clock.h"
+#include "random.h"
+#include "profiler.h"
+#include "render_stats.h"
+#include "job_system.h"
+#include "texture_loader.h"
 #include <stdexcept>
 
 
@@ -31,11 +40,33 @@ const unsigned int window_width_g = 1280;
 const unsigned int window_height_g = 720;
 const glm::vec3 viewport_background_color_g(0.0, 0.0, 1.0);
 
+// Globals that define the simulation rate
+const double simulation_rate_g = 120.0;      // Fixed steps per second
+const int max_simulation_steps_g = 8;        // Steps run per frame at most before the simulation slows down
+
+// Globals that define the world's population
+const int max_enemies_per_type_g = 2;        // Enemies of each type alive at once
+const int dust_particle_count_g = 3000;      // Particles in the space dust field
+
+// Globals that define how the enemy update is split across threads
+const size_t enemy_job_grain_g = 64;         // Enemies per job chunk
+
+// Globals that define how textures stream in
+const double texture_upload_budget_ms_g = 2.0;  // Upload time per frame while loading
+
+// Globals that define the music
+const char* level1_music_g = "background.wav";
+const char* level2_music_g = "background_level2.wav";
+const float level_music_fade_g = 2.0f;       // Crossfade between level tracks, in seconds
+
 
 
 // Directory with game resources such as textures
 const std::string resources_directory_g = RESOURCES_DIRECTORY;
 
+// Sound effects packed at build time by sound_bank_pack
+const std::string sound_bank_file_g = SOUND_BANK_FILE;
+
 
 void Game::SetupGameWorld(void)
 {
@@ -74,7 +105,12 @@ void Game::SetupGameWorld(void)
 
 
 
-    try {
+    if (headless_) {
+        // Nothing is drawn, objects only need texture slots
+        num_textures = textures.size();
+        tex_ = new GLuint[num_textures]();
+    }
+    else try {
         LoadTextures(textures);
 
         // Verify textures loaded properly before proceeding
@@ -97,50 +133,59 @@ void Game::SetupGameWorld(void)
     player->SetProjectileTexture(tex_[tex_projectile]);     // Set projectile texture
     player->SetRotation(glm::pi<float>() / 2.0f);
     player->SetMissileTexture(tex_[tex_missile]);
-    game_objects_.push_back(player);
+    player->SetImmortal(player_immortal_);
+    player_ = entities_.Players().Add(player);
 
 
     //time text
     GameTimer* time_obj = new GameTimer(glm::vec3(-3.5f, 3.5f, 0.0f), sprite_, &text_shader_, tex_[14]);
     time_obj->SetScale(1.6 * 0.8, 0.4 * 0.8);
-    time_obj->SetReferenceTime(glfwGetTime());
-    game_objects_.push_back(time_obj);
+    time_obj->SetReferenceTime(GameClock::Now());
+    time_ui_ = time_obj;
+    entities_.Texts().Add(time_obj);
 
     //enemy count text
     EnemyCounter* enemy_counter = new EnemyCounter(glm::vec3(-3.5f, 2.5f, 0.0f), sprite_, &text_shader_, tex_[14]);
     enemy_counter->SetScale(2.5 * 0.8, 0.4 * 0.8);
     enemy_count_ = enemy_counter;
-    game_objects_.push_back(enemy_counter);
+    entities_.Texts().Add(enemy_counter);
 
     // SpawnBoss();
 
-    // Create space dust particle system
-    space_dust_ = new SpaceDust(
-        glm::vec3(0.0f, 0.0f, 0.0f),
-        sprite_,
-        &dust_shader_,
-        tex_[tex_particle],  // Use the particle texture or create a new one for dust
-        3000  // Number of dust particles
-    );
+    // Visual-only systems need a GL context
+    if (!headless_) {
+        // Create space dust particle system
+        space_dust_ = new SpaceDust(
+            glm::vec3(0.0f, 0.0f, 0.0f),
+            sprite_,
+            &dust_shader_,
+            tex_[tex_particle],  // Use the particle texture or create a new one for dust
+            dust_particle_count_,  // Number of dust particles
+            40.0f, 40.0f  // Bounds larger than the game area
+        );
+
+        entities_.Effects().Add(space_dust_);
 
-    space_dust_->SetBounds(40.0f, 40.0f);  // Set bounds larger than game area
-    game_objects_.push_back(space_dust_);
+        // Missile flames share one particle emitter
+        flame_emitter_.Init(sprite_, &particle_shader_, tex_[tex_flame_particle], &entities_);
+    }
 
-    // Setup background (will be the last in vector for proper rendering)
-    GameObject* background = new GameObject(glm::vec3(0.0f, 0.0f, 0.0f),
+    // Setup background (rendered before all entities)
+    background_ = new GameObject(glm::vec3(0.0f, 0.0f, 0.0f),
         sprite_, &sprite_shader_, tex_[tex_stars]);
 
     // Set a large scale for the background
-    background->SetScale(100.0f);
-
-    game_objects_.push_back(background);
+    background_->SetScale(100.0f);
+    background_->SetRenderState(RenderState::Backdrop());
 
     SpawnAsteroid(5);  // Spawn 5 asteroids
 
     // Enable shader to set uniform
-    sprite_shader_.Enable();
-    sprite_shader_.SetUniform1f("texture_scale", 15.0f);
-    sprite_shader_.Disable();
+    if (!headless_) {
+        sprite_shader_.Enable();
+        sprite_shader_.SetUniform1f(sprite_shader_.GetUniformId("texture_scale"), 15.0f);
+        sprite_shader_.Disable();
+    }
 
     // EnemyCounter* enemy_counter = new EnemyCounter(
     //     glm::vec3(-3.5f, 2.5f, 0.0f),  // Position (will be updated to follow player)
@@ -153,8 +198,6 @@ void Game::SetupGameWorld(void)
     // enemy_counter->SetScale(3.3f, 0.5f);  // Set appropriate scale for text
     // enemy_count_ = enemy_counter;         // Store reference in class member
 
-    game_objects_.insert(game_objects_.end() - 1, enemy_counter);
-
 
     // NOW spawn collectibles and enemies AFTER both player and background are added
     SpawnCollectibles(5);
@@ -163,6 +206,11 @@ void Game::SetupGameWorld(void)
 
     enemy_projectile_texture_ = tex_[tex_enemy_projectile];
 
+    // The UI and mini map only draw
+    if (headless_) {
+        return;
+    }
+
     InitUI();
 
 
@@ -187,23 +235,52 @@ void Game::LoadTextures(std::vector<std::string>& textures) {
     // Allocate a buffer for all texture references
     num_textures = textures.size();  // Store in class member
     tex_ = new GLuint[num_textures];
-    glGenTextures(num_textures, tex_);
 
-    // Load each texture
+    // Sprites drawn through the batch also go into the sprite array:
+    // ships, shots, pickups, asteroids, explosions and boss parts
+    std::vector<bool> packed(num_textures, false);
+    const int sprite_textures[] = {
+        tex_player, tex_enemy1, tex_enemy2, tex_enemy_fast, tex_enemy_heavy,
+        tex_orb, tex_explosion, tex_player_invincible, tex_projectile, tex_missile,
+        tex_enemy_projectile, tex_asteroid, tex_collectible_speed, tex_collectible_power,
+        tex_base, tex_lower_part, tex_upper_part
+    };
+    for (int texture : sprite_textures) {
+        if (texture < num_textures) {
+            packed[texture] = true;
+        }
+    }
+
+    // Every texture name is valid right away; the images are decoded in the
+    // background and uploaded a few per frame by MainLoop
+    texture_loader_.SetSpriteArray(&sprite_array_);
     for (int i = 0; i < num_textures; i++) {
         std::string full_path = resources_directory_g + textures[i];
-        SetTexture(tex_[i], full_path.c_str());
+
+        // The backgrounds tile
+        bool repeat = textures[i].find("stars.png") != std::string::npos ||
+            textures[i].find("stage_2.png") != std::string::npos;
+        tex_[i] = texture_loader_.Load(full_path, repeat, packed[i]);
 
         // Verify texture was loaded successfully
         if (tex_[i] == 0) {
             throw std::runtime_error("Failed to load texture: " + full_path);
         }
     }
+    sprite_array_.Init();
+    texture_loader_.Start();
 
     // Set first texture in the array as default
     glBindTexture(GL_TEXTURE_2D, tex_[0]);
 }
 
+
+void Game::WaitForTextures(void) {
+    if (!headless_) {
+        texture_loader_.Finish();
+    }
+}
+
 void Game::InitUI() {
     std::cout << "Initializing UI started" << std::endl;
 
@@ -252,7 +329,7 @@ void Game::CreateHomingMissile(const glm::vec3& position, const glm::vec3& direc
         power_multiplier = player->GetPowerBuff();
     }
     // Create a new homing missile
-    HomingMissile* missile = new HomingMissile(
+    HomingMissile* missile = entities_.HomingMissiles().Create(
         position,
         sprite_,
         &sprite_shader_,
@@ -262,77 +339,58 @@ void Game::CreateHomingMissile(const glm::vec3& position, const glm::vec3& direc
 
     missile->SetDamage(2.0f * power_multiplier);
 
-    // Find closest enemy as initial target
-    GameObject* target = FindClosestEnemy(position);
-    if (target) {
-        missile->SetTarget(target);
-    }
+    // Initial target, ahead of the launch direction
+    missile->SetTarget(&entities_, FindMissileTarget(missile));
 
     // Add the missile to game objects
-    game_objects_.insert(game_objects_.end() - 1, missile);
-
-    // Create flame particle effect for the missile
-    MissileFlame* flame = new MissileFlame(
-        position,
-        sprite_,
-        &particle_shader_,
-        tex_[24],
-        missile
-    );
+    EntityHandle missile_handle = entities_.HomingMissiles().Add(missile);
 
-    // Add flame to game objects (insert before background)
-    game_objects_.insert(game_objects_.end() - 1, flame);
+    // Give the missile an exhaust flame
+    flame_emitter_.AddSource(missile_handle);
 
     // Play missile firing sound
-    audio_system_.PlaySound(fire_sound_);
+    audio_system_.PlaySoundAt(fire_sound_, SOUND_FIRE, position);
 }
 
-GameObject* Game::FindClosestEnemy(const glm::vec3& position, float max_distance) {
-    GameObject* closest_enemy = nullptr;
-    float closest_distance = max_distance;
-
-    // Search through all game objects for enemies
-    for (int i = 1; i < game_objects_.size() - 1; i++) {
-        EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(game_objects_[i]);
-
-        // Check if it's a valid enemy
-        if (enemy && enemy->IsActive() && !enemy->IsExploding()) {
-            float distance = glm::length(enemy->GetPosition() - position);
-
-            // Check if this enemy is closer than the current closest
-            if (distance < closest_distance) {
-                closest_enemy = enemy;
-                closest_distance = distance;
+EntityHandle Game::FindMissileTarget(const HomingMissile* missile) const {
+    // The grid holds the enemies that were alive when the tick started
+    const SpatialGrid::Entry* entry = collision_grid_.FindBest(missile->GetPosition(), HomingMissile::SEEK_RANGE,
+        [missile](const SpatialGrid::Entry& entry) {
+            if (entry.handle.kind != EntityKind::ENEMY) {
+                return -1.0f;
             }
+            return missile->TargetCost(entry.position);
+        });
+    return entry ? entry->handle : EntityHandle();
+}
+
+void Game::RetargetMissiles(void) {
+    const EntityPool<HomingMissile>& missiles = entities_.HomingMissiles();
+    for (size_t i = 0; i < missiles.Size(); i++) {
+        HomingMissile* missile = missiles[i];
+        if (missile->IsActive() && !missile->IsExploding() && missile->NeedsTarget()) {
+            missile->SetTarget(&entities_, FindMissileTarget(missile));
         }
     }
-
-    return closest_enemy;
 }
 
 // spawn collectibles method
 // In SpawnCollectibles method:
 void Game::SpawnCollectibles(int count) {
     // Safety check
-    if (game_objects_.size() < 2) {  // Need at least player and background
+    if (entities_.Players().Empty() || !background_) {  // Need at least player and background
         std::cerr << "Warning: Not enough game objects for spawning collectibles" << std::endl;
         return;
     }
 
-    // Verify texture exists
-    if (tex_ == nullptr || tex_[tex_orb] == 0) {
-        std::cerr << "Warning: Invalid orb texture" << std::endl;
-        return;
-    }
-
     for (int i = 0; i < count; i++) {
         // Generate random position between -5 and 5 for both x and y
         const float BOUND = 20.0f;  // Match the boundary from HandleControls
-        float rand_x = ((float)rand() / RAND_MAX) * (2 * BOUND) - BOUND;
-        float rand_y = ((float)rand() / RAND_MAX) * (2 * BOUND) - BOUND;
+        float rand_x = Random::Range(RandomStream::COLLECTIBLES, -BOUND, BOUND);
+        float rand_y = Random::Range(RandomStream::COLLECTIBLES, -BOUND, BOUND);
 
         // Random collectible object type
-        int random_type = rand() % 10;
+        int random_type = Random::Index(RandomStream::COLLECTIBLES, 10);
         Type type;
         GLuint texture_use;
 
@@ -361,8 +419,7 @@ void Game::SpawnCollectibles(int count) {
             type
         );
 
-        // Insert before the background (which is last)
-        game_objects_.insert(game_objects_.end() - 1, collectible);
+        entities_.Collectibles().Add(collectible);
     }
 }
 
@@ -383,7 +440,7 @@ void Game::CreateEnemyProjectile(const glm::vec3& position, const glm::vec3& dir
     }
 
     // Create a new projectile object with the specified direction
-    Projectile* projectile = new Projectile(
+    Projectile* projectile = entities_.Projectiles().Create(
         position,
         sprite_,
         &sprite_shader_,
@@ -399,32 +456,23 @@ void Game::CreateEnemyProjectile(const glm::vec3& position, const glm::vec3& dir
     projectile->SetScale(scale);
     projectile->SetDamage(damage);
 
-    // Add the projectile to the game objects vector
-    game_objects_.insert(game_objects_.end() - 1, projectile);
+    // Add the projectile to the game objects
+    EntityHandle projectile_handle = entities_.Projectiles().Add(projectile);
 
     // Add flame particles only for missiles (enemy type 2)
     if (is_missile) {
-        // Create flame particle effect for the missile
-        MissileFlame* flame = new MissileFlame(
-            position,
-            sprite_,
-            &particle_shader_,
-            tex_[24],
-            projectile
-        );
-
-        // Add flame to game objects (insert before background)
-        game_objects_.insert(game_objects_.end() - 1, flame);
+        // Give the missile an exhaust flame
+        flame_emitter_.AddSource(projectile_handle);
     }
 
     // Play appropriate firing sound
-    audio_system_.PlaySound(fire_sound_);
+    audio_system_.PlaySoundAt(fire_sound_, SOUND_FIRE, position);
 }
 
 
 FastEnemyGameObject* Game::CreateFastEnemy(const glm::vec3& position) {
     // Check if we already have the maximum number of fast enemies
-    if (fast_enemy_count_ >= MAX_ENEMIES_PER_TYPE) {
+    if (fast_enemy_count_ >= max_enemies_per_type_) {
         return nullptr;
     }
 
@@ -442,8 +490,8 @@ FastEnemyGameObject* Game::CreateFastEnemy(const glm::vec3& position) {
     enemy->SetProjectileTexture(tex_[tex_enemy_projectile]);
 
     // Set patrol parameters (smaller, faster ellipse)
-    float width = 0.8f + ((float)rand() / RAND_MAX) * 1.5f;  // 0.8 to 2.3
-    float height = 0.8f + ((float)rand() / RAND_MAX) * 1.0f; // 0.8 to 1.8
+    float width = Random::Range(RandomStream::SPAWN, 0.8f, 2.3f);  // 0.8 to 2.3
+    float height = Random::Range(RandomStream::SPAWN, 0.8f, 1.8f); // 0.8 to 1.8
     enemy->SetPatrolParameters(position, width, height);
 
     // Increment counter
@@ -454,7 +502,7 @@ FastEnemyGameObject* Game::CreateFastEnemy(const glm::vec3& position) {
 
 HeavyEnemyGameObject* Game::CreateHeavyEnemy(const glm::vec3& position) {
     // Check if we already have the maximum number of heavy enemies
-    if (heavy_enemy_count_ >= MAX_ENEMIES_PER_TYPE) {
+    if (heavy_enemy_count_ >= max_enemies_per_type_) {
         return nullptr;
     }
 
@@ -472,8 +520,8 @@ HeavyEnemyGameObject* Game::CreateHeavyEnemy(const glm::vec3& position) {
     enemy->SetProjectileTexture(tex_[tex_enemy_projectile]);
 
     // Set patrol parameters (larger, slower ellipse)
-    float width = 1.5f + ((float)rand() / RAND_MAX) * 2.5f;  // 1.5 to 4.0
-    float height = 1.5f + ((float)rand() / RAND_MAX) * 2.0f; // 1.5 to 3.5
+    float width = Random::Range(RandomStream::SPAWN, 1.5f, 4.0f);  // 1.5 to 4.0
+    float height = Random::Range(RandomStream::SPAWN, 1.5f, 3.5f); // 1.5 to 3.5
     enemy->SetPatrolParameters(position, width, height);
 
     // Increment counter
@@ -486,18 +534,22 @@ HeavyEnemyGameObject* Game::CreateHeavyEnemy(const glm::vec3& position) {
 
 void Game::DestroyGameWorld(void) {
     // Clear out any special pointers first to avoid double deletion
-    boss_ = nullptr;
+    boss_ = EntityHandle();
+    player_ = EntityHandle();
     enemy_count_ = nullptr;
     time_ui_ = nullptr;
     space_dust_ = nullptr;
 
+    // The spawn callback refers back to the game
+    GameClock::Cancel(enemy_spawn_event_);
+    enemy_spawn_event_ = 0;
+
     // Free memory for all game objects
-    for (auto obj : game_objects_) {
-        delete obj;
-    }
+    entities_.Clear();
+    flame_emitter_.Clear();
 
-    // Clear the vector after deleting all objects
-    game_objects_.clear();
+    delete background_;
+    background_ = nullptr;
 
     // Reset counters
     regular_enemy_count_ = 0;
@@ -515,57 +567,58 @@ void Game::CheckLevelProgression(){
 
 void Game::ClearGameObjects(bool keep_player_and_background){
     if (keep_player_and_background) {
-        PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(game_objects_[0]);
-        GameObject* background = game_objects_.back();
-        std::vector<GameObject*> ui_elements;
-    
-        for (int i = 1; i < game_objects_.size() - 1; i++) {
-            if (dynamic_cast<GameTimer*>(game_objects_[i]) || dynamic_cast<HealthBar*>(game_objects_[i])) {
-                ui_elements.push_back(game_objects_[i]);
-            } else {
-                delete game_objects_[i];
-            }
-        }
-        game_objects_.clear();
-        game_objects_.push_back(player);
-        for (auto ui : ui_elements) {
-            game_objects_.push_back(ui);
-        }
-        game_objects_.push_back(background);
+        // Keep the player, UI text, effects and background
+        flame_emitter_.Clear();
+        entities_.HomingMissiles().Clear();
+        entities_.Projectiles().Clear();
+        entities_.Enemies().Clear();
+        entities_.Bosses().Clear();
+        entities_.Collectibles().Clear();
+        entities_.Asteroids().Clear();
     }else {
-        for (auto obj : game_objects_) {
-            delete obj;
-        }
-        game_objects_.clear();
-    }
+        enemy_count_ = nullptr;
+        time_ui_ = nullptr;
+        space_dust_ = nullptr;
+        player_ = EntityHandle();
+        entities_.Clear();
+        flame_emitter_.Clear();
+        delete background_;
+        background_ = nullptr;
+    }
+    boss_ = EntityHandle();
     regular_enemy_count_ = 0;
     fast_enemy_count_ = 0;
     heavy_enemy_count_ = 0;
 }
 
+BossGameObject* Game::GetBoss() const {
+    return entities_.Bosses().Get(boss_);
+}
+
 void Game::SpawnBoss(){
-    boss_ = new BossGameObject(
+    BossGameObject* boss = new BossGameObject(
         glm::vec3(0.0f, 0.0f, 0.0f),
         sprite_,
         &sprite_shader_,
         tex_[20]
     );
 
-    boss_->SetExplosionTexture(tex_[tex_explosion]);
-    boss_->SetArmTexture(tex_[21]);
-    boss_->SetJointTexture(tex_[22]);
-    boss_->SetProjectileTexture(tex_[tex_enemy_projectile]);
-    boss_->SetMissileTexture(tex_[tex_missile]);
+    boss->SetExplosionTexture(tex_[tex_explosion]);
+    boss->SetArmTexture(tex_[21]);
+    boss->SetJointTexture(tex_[22]);
+    boss->SetProjectileTexture(tex_[tex_enemy_projectile]);
+    boss->SetMissileTexture(tex_[tex_missile]);
 
-    boss_->SetScale(3.0f);
-    game_objects_.insert(game_objects_.end() -1, boss_);
+    boss->SetScale(3.0f);
+    boss_ = entities_.Bosses().Add(boss);
 
     std::cout << "Boss spawned!" << std::endl;
 }
 
 void Game::ProcessBossPlayerCollision(double delta_time) {
     // Only process if boss exists and is active
-    if (!boss_ || !boss_->IsActive() || boss_->IsExploding()) {
+    BossGameObject* boss = GetBoss();
+    if (!boss || !boss->IsActive() || boss->IsExploding()) {
         return;
     }
 
@@ -579,46 +632,19 @@ void Game::ProcessBossPlayerCollision(double delta_time) {
     glm::vec3 player_pos = player->GetPosition();
     float player_radius = 0.8f;
 
-    // Get boss parts positions and collision data
-    struct BossPart {
-        glm::vec3 position;
-        float radius;
-        std::string name;
-    };
-
-    // Collect all boss parts for collision checking
-    std::vector<BossPart> boss_parts;
-
-    // Main base part
-    boss_parts.push_back({
-        boss_->GetPosition(),
-        1.5f,
-        "Base"
-        });
-
-    // Get boss arm positions - using the boss methods to access arm data
-    std::vector<glm::vec3> arm_positions = boss_->GetArmPositions();
-    std::vector<float> arm_radii = boss_->GetArmRadii();
-
-    // Add arm parts to collision check list
-    if (arm_positions.size() == arm_radii.size()) {
-        for (size_t i = 0; i < arm_positions.size(); i++) {
-            boss_parts.push_back({
-                arm_positions[i],
-                arm_radii[i],
-                "Arm part " + std::to_string(i + 1)
-                });
-        }
-    }
-
-    // Check collision with each part
+    // Check collision with each boss part near the player
+    // The base (part 0) and arm parts are in the collision grid
     bool collision = false;
     glm::vec3 collision_pos;
     glm::vec3 push_direction;
     float push_force = 12.0f;
     std::string collision_part = "";
 
-    for (const auto& part : boss_parts) {
+    collision_grid_.QueryCircle(player_pos, player_radius, [&](const SpatialGrid::Entry& part) {
+        if (part.handle != boss_) {
+            return true;
+        }
+
         // Calculate distance between player and this boss part
         float distance = glm::length(player_pos - part.position);
 
@@ -627,19 +653,20 @@ void Game::ProcessBossPlayerCollision(double delta_time) {
             collision = true;
             collision_pos = part.position;
             push_direction = glm::normalize(player_pos - part.position);
-            collision_part = part.name;
+            collision_part = part.part == 0 ? "Base" : "Arm part " + std::to_string(part.part);
 
             // We can break on first collision or process all and use the strongest one
-            break;
+            return false;
         }
-    }
+        return true;
+    });
 
     // Handle collision if it occurred
     if (collision) {
         // If player is not invincible, apply damage
         if (!player->IsInvincible()) {
             player->TakeDamage(1.0f);
-            audio_system_.PlaySound(hit_sound_);
+            audio_system_.PlaySoundAt(hit_sound_, SOUND_HIT, player->GetPosition());
         }
 
         // Calculate push velocity
@@ -649,6 +676,7 @@ void Game::ProcessBossPlayerCollision(double delta_time) {
         float safe_distance = player_radius + 1.2f; // Extra margin
         glm::vec3 safe_position = collision_pos + push_direction * safe_distance;
         player->SetPosition(safe_position);
+        player->SnapTransform();
 
         // Apply sliding effect to player (bounce off the boss)
         player->StartSliding(push_velocity);
@@ -667,20 +695,24 @@ void Game::TransitionToLevel2(){
     std::cout << "Transitioning to Level 2!" << std::endl;
     transitioning_to_level2_ = true;
     current_level_ = 2;
-    GameObject* background = game_objects_.back();
+    GameObject* background = background_;
 
     if(background){
         background->SetTexture(tex_[19]);
         background->SetScale(100.0f);
     }
 
+    audio_system_.PlayMusic(resources_directory_g + "/audio/" + level2_music_g, level_music_fade_g);
+
     transitioning_to_level2_ = false;
 }
 
 
 void Game::HandleControls(double delta_time) {
+    PROFILE_ZONE("HandleControls");
+
     // Get player game object
-    PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(game_objects_[0]);
+    PlayerGameObject* player = GetPlayer();
 
     // Don't process controls if player is exploding or inactive
     if (!player || player->IsExploding() || !player->IsActive()) {
@@ -705,58 +737,44 @@ void Game::HandleControls(double delta_time) {
     glm::vec3 new_pos;
 
     // Process controls with bounds checking
-    if (glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS) {
+    if (input_ & INPUT_FORWARD) {
         new_pos = curpos + motion_increment * dir;
         if (abs(new_pos.x) <= BOUND && abs(new_pos.y) <= BOUND) {
             player->SetPosition(new_pos);
         }
     }
-    if (glfwGetKey(window_, GLFW_KEY_S) == GLFW_PRESS) {
+    if (input_ & INPUT_BACKWARD) {
         new_pos = curpos - motion_increment * dir;
         if (abs(new_pos.x) <= BOUND && abs(new_pos.y) <= BOUND) {
             player->SetPosition(new_pos);
         }
     }
-    if (glfwGetKey(window_, GLFW_KEY_D) == GLFW_PRESS) {
+    if (input_ & INPUT_TURN_RIGHT) {
         player->SetRotation(angle - angle_increment);
     }
-    if (glfwGetKey(window_, GLFW_KEY_A) == GLFW_PRESS) {
+    if (input_ & INPUT_TURN_LEFT) {
         player->SetRotation(angle + angle_increment);
     }
-    if (glfwGetKey(window_, GLFW_KEY_Z) == GLFW_PRESS) {
+    if (input_ & INPUT_STRAFE_LEFT) {
         new_pos = curpos - motion_increment * right;
         if (abs(new_pos.x) <= BOUND && abs(new_pos.y) <= BOUND) {
             player->SetPosition(new_pos);
         }
     }
-    if (glfwGetKey(window_, GLFW_KEY_C) == GLFW_PRESS) {
+    if (input_ & INPUT_STRAFE_RIGHT) {
         new_pos = curpos + motion_increment * right;
         if (abs(new_pos.x) <= BOUND && abs(new_pos.y) <= BOUND) {
             player->SetPosition(new_pos);
         }
     }
-    // Add Q key for weapon switching
-    static bool q_pressed = false;
-    if (glfwGetKey(window_, GLFW_KEY_Q) == GLFW_PRESS) {
-        if (!q_pressed) {
-            player->SwitchWeapon();
-            q_pressed = true;
-        }
-    }
-    else {
-        q_pressed = false;
-    }
-
-    if (glfwGetKey(window_, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window_, true);
+    // Q switches weapon once per press
+    if ((input_ & INPUT_SWITCH_WEAPON) && !(previous_input_ & INPUT_SWITCH_WEAPON)) {
+        player->SwitchWeapon();
     }
 }
 
 PlayerGameObject* Game::GetPlayer() const {
-    if (!game_objects_.empty()) {
-        return dynamic_cast<PlayerGameObject*>(game_objects_[0]);
-    }
-    return nullptr;
+    return entities_.Players().Get(player_);
 }
 
 void Game::CreateProjectile(const glm::vec3& position, const glm::vec3& direction) {
@@ -766,7 +784,7 @@ void Game::CreateProjectile(const glm::vec3& position, const glm::vec3& directio
         power_multiplier = player->GetPowerBuff();
     }
     // Create a new projectile object
-    Projectile* projectile = new Projectile(
+    Projectile* projectile = entities_.Projectiles().Create(
         position,
         sprite_,
         &sprite_shader_,
@@ -776,20 +794,19 @@ void Game::CreateProjectile(const glm::vec3& position, const glm::vec3& directio
 
     projectile->SetDamage(1.0f * power_multiplier);
 
-    // Add the projectile to the game objects vector
-    // Insert before the background (which is the last object)
-    game_objects_.insert(game_objects_.end() - 1, projectile);
+    // Add the projectile to the game objects
+    entities_.Projectiles().Add(projectile);
 
     // Play firing sound if available
     if (fire_sound_ != 0) {
-        audio_system_.PlaySound(fire_sound_);
+        audio_system_.PlaySoundAt(fire_sound_, SOUND_FIRE, position);
     }
 }
 
 
 // Function to spawn initial enemies
 void Game::SpawnInitialEnemies(int count) {
-    if (game_objects_.size() < 2) {
+    if (entities_.Players().Empty() || !background_) {
         std::cerr << "Warning: Not enough game objects for spawning enemies" << std::endl;
         return;
     }
@@ -800,24 +817,24 @@ void Game::SpawnInitialEnemies(int count) {
     heavy_enemy_count_ = 0;
 
     // Distribution of initial enemies
-    for (int i = 0; i < MAX_ENEMIES_PER_TYPE; i++) {
+    for (int i = 0; i < max_enemies_per_type_; i++) {
         // Create each type of enemy, positioned in different areas
         float x, y;
-        GameObject* enemy = nullptr;
+        EnemyGameObject* enemy = nullptr;
 
         // Fast enemies in a circular pattern
-        float angle = ((float)i / MAX_ENEMIES_PER_TYPE) * 2.0f * glm::pi<float>();
-        float radius = 8.0f + ((float)rand() / RAND_MAX) * 4.0f; // 8-12 units from center
+        float angle = ((float)i / max_enemies_per_type_) * 2.0f * glm::pi<float>();
+        float radius = Random::Range(RandomStream::SPAWN, 8.0f, 12.0f); // 8-12 units from center
         x = radius * cos(angle);
         y = radius * sin(angle);
         enemy = CreateFastEnemy(glm::vec3(x, y, 0.0f));
         if (enemy) {
-            game_objects_.insert(game_objects_.end() - 1, enemy);
+            entities_.Enemies().Add(enemy);
         }
 
         // Heavy enemies in the corners
         int corner = i % 4;
-        float offset = 3.0f + ((float)rand() / RAND_MAX) * 4.0f; // Random offset
+        float offset = Random::Range(RandomStream::SPAWN, 3.0f, 7.0f); // Random offset
         switch (corner) {
         case 0: x = 15.0f - offset; y = 15.0f - offset; break; // Top-right
         case 1: x = -15.0f + offset; y = 15.0f - offset; break; // Top-left
@@ -826,16 +843,16 @@ void Game::SpawnInitialEnemies(int count) {
         }
         enemy = CreateHeavyEnemy(glm::vec3(x, y, 0.0f));
         if (enemy) {
-            game_objects_.insert(game_objects_.end() - 1, enemy);
+            entities_.Enemies().Add(enemy);
         }
 
         // Regular enemies in random positions
         const float BOUND = 18.0f;
-        x = ((float)rand() / RAND_MAX) * (2 * BOUND) - BOUND;
-        y = ((float)rand() / RAND_MAX) * (2 * BOUND) - BOUND;
+        x = Random::Range(RandomStream::SPAWN, -BOUND, BOUND);
+        y = Random::Range(RandomStream::SPAWN, -BOUND, BOUND);
         enemy = CreateEnemy(glm::vec3(x, y, 0.0f));
         if (enemy) {
-            game_objects_.insert(game_objects_.end() - 1, enemy);
+            entities_.Enemies().Add(enemy);
         }
     }
 
@@ -844,7 +861,7 @@ void Game::SpawnInitialEnemies(int count) {
         << heavy_enemy_count_ << " heavy enemies." << std::endl;
 
     // Initialize spawn timer with a shorter interval
-    enemy_spawn_timer_.Start(5.0f);
+    ScheduleEnemySpawn(5.0);
 }
 
 
@@ -897,7 +914,7 @@ void Game::ProcessProjectileEnemyCollisions(Projectile* projectile, EnemyGameObj
             }
 
             // Play explosion sound
-            audio_system_.PlaySound(explosion_sound_);
+            audio_system_.PlaySoundAt(explosion_sound_, SOUND_EXPLOSION, enemy->GetPosition());
 
             std::cout << "Enemy destroyed by projectile!" << std::endl;
         }
@@ -911,18 +928,19 @@ void Game::ProcessProjectileEnemyCollisions(Projectile* projectile, EnemyGameObj
 }
 
 void Game::UpdateBoss(double delta_time) {
-    if (!boss_ || !boss_->IsActive()) {
+    BossGameObject* boss = GetBoss();
+    if (!boss || !boss->IsActive()) {
         return;
     }
-    if (boss_->CanProjectiles()) {
-        std::vector<glm::vec3> spawn_points = boss_->GetProjectileSpawnPoints();
-        std::vector<glm::vec3> directions = boss_->GetProjectileDirections();
+    if (boss->CanProjectiles()) {
+        std::vector<glm::vec3> spawn_points = boss->GetProjectileSpawnPoints();
+        std::vector<glm::vec3> directions = boss->GetProjectileDirections();
         for (int i = 0;i < spawn_points.size();i++) {
             if (i < directions.size()) {
                 CreateEnemyProjectile(spawn_points[i], directions[i], 0);
             }
         }
-        boss_->FireProjectiles();
+        boss->FireProjectiles();
     }
     // if(boss_->CanMissile()){
     //     glm::vec3 spawn_point = boss_->GetMissileSpawnPoint();
@@ -933,10 +951,10 @@ void Game::UpdateBoss(double delta_time) {
     //     }
     //     boss_->FireMissile();
     // }
-    for (int i = 1;i < game_objects_.size() - 1;i++) {
-        Projectile* projectile = dynamic_cast<Projectile*>(game_objects_[i]);
-        if (projectile && projectile->IsActive() && !projectile->IsEnemyProjectile()) {
-            float distance = glm::length(projectile->GetPosition() - boss_->GetPosition());
+    // Player projectiles and homing missiles both damage the boss on contact
+    auto hit_boss = [&](Projectile* projectile) {
+        if (projectile->IsActive() && !projectile->IsEnemyProjectile()) {
+            float distance = glm::length(projectile->GetPosition() - boss->GetPosition());
             if (distance < 1.5f) {
                 // Get player for power buff
                 PlayerGameObject* player = GetPlayer();
@@ -948,25 +966,25 @@ void Game::UpdateBoss(double delta_time) {
                 // Apply damage with power multiplier
                 float damage = projectile->GetDamage() * power_multiplier;
 
-                bool phase_changed = boss_->TakeDamage(damage);
+                bool phase_changed = boss->TakeDamage(damage);
                 projectile->SetActive(false);
             }
         }
+    };
+    for (Projectile* projectile : entities_.Projectiles()) {
+        hit_boss(projectile);
+    }
+    for (HomingMissile* missile : entities_.HomingMissiles()) {
+        hit_boss(missile);
     }
 }
 
 void Game::SetupBoss(){
     std::cout << "Setting up boss for level 2..." << std::endl;
-    for (int i = 1; i < game_objects_.size() - 1; i++) {
-        EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(game_objects_[i]);
-        Projectile* projectile = dynamic_cast<Projectile*>(game_objects_[i]);
-        
-        if (enemy || projectile) {
-            delete game_objects_[i];
-            game_objects_.erase(game_objects_.begin() + i);
-            i--;
-        }
-    }
+    // Flames notice their missiles are gone through their stale handles
+    entities_.Enemies().Clear();
+    entities_.Projectiles().Clear();
+    entities_.HomingMissiles().Clear();
     
     regular_enemy_count_ = 0;
     fast_enemy_count_ = 0;
@@ -991,7 +1009,7 @@ void Game::SetupBoss(){
 
 //     // Play firing sound if available
 //     if (fire_sound_ != 0) {
-//         audio_system_.PlaySound(fire_sound_);
+//         audio_system_.PlaySound(fire_sound_, SOUND_FIRE);
 //     }
 // }
 
@@ -1035,34 +1053,34 @@ void Game::ProcessBossProjectileCollisions(Projectile* projectile, BossGameObjec
 
 // spawn an enemy at a random position
 void Game::SpawnEnemy() {
-    if (game_objects_.size() < 2) {
+    if (entities_.Players().Empty() || !background_) {
         std::cerr << "Warning: Not enough game objects for spawning enemies" << std::endl;
         return;
     }
 
     // Generate random position using the full map boundaries
     const float BOUND = 20.0f;
-    float rand_x = ((float)rand() / RAND_MAX) * (2 * BOUND) - BOUND;
-    float rand_y = ((float)rand() / RAND_MAX) * (2 * BOUND) - BOUND;
+    float rand_x = Random::Range(RandomStream::SPAWN, -BOUND, BOUND);
+    float rand_y = Random::Range(RandomStream::SPAWN, -BOUND, BOUND);
 
     // Try to spawn a random enemy type, prioritizing types under the limit
-    GameObject* enemy = nullptr;
+    EnemyGameObject* enemy = nullptr;
 
     // Create a list of enemy types that haven't reached their limit
     std::vector<int> available_types;
-    if (regular_enemy_count_ < MAX_ENEMIES_PER_TYPE) available_types.push_back(0);
-    if (fast_enemy_count_ < MAX_ENEMIES_PER_TYPE) available_types.push_back(1);
-    if (heavy_enemy_count_ < MAX_ENEMIES_PER_TYPE) available_types.push_back(2);
+    if (regular_enemy_count_ < max_enemies_per_type_) available_types.push_back(0);
+    if (fast_enemy_count_ < max_enemies_per_type_) available_types.push_back(1);
+    if (heavy_enemy_count_ < max_enemies_per_type_) available_types.push_back(2);
 
     // If all types have reached their limit, don't spawn
     if (available_types.empty()) {
         std::cout << "All enemy types at maximum capacity!" << std::endl;
-        enemy_spawn_timer_.Start(5.0f);
+        ScheduleEnemySpawn(5.0);
         return;
     }
 
     // Choose a random available type
-    int enemy_type = available_types[rand() % available_types.size()];
+    int enemy_type = available_types[Random::Index(RandomStream::SPAWN, static_cast<int>(available_types.size()))];
 
     switch (enemy_type) {
     case 0:
@@ -1076,19 +1094,33 @@ void Game::SpawnEnemy() {
         break;
     }
 
-    // Insert before the background
     if (enemy) {
-        game_objects_.insert(game_objects_.end() - 1, enemy);
+        entities_.Enemies().Add(enemy);
     }
 
     // Restart spawn timer
-    enemy_spawn_timer_.Start(5.0f);
+    ScheduleEnemySpawn(5.0);
+}
+
+
+void Game::ScheduleEnemySpawn(double delay) {
+    GameClock::Cancel(enemy_spawn_event_);
+    enemy_spawn_event_ = GameClock::Schedule(delay, [this]() {
+        enemy_spawn_event_ = 0;
+        if (!game_over_) {
+            SpawnEnemy();
+        }
+        // Keep trying if the spawn bailed out early
+        if (!enemy_spawn_event_) {
+            ScheduleEnemySpawn(5.0);
+        }
+    });
 }
 
 // create a new enemy object
 EnemyGameObject* Game::CreateEnemy(const glm::vec3& position) {
     // Check if we already have the maximum number of regular enemies
-    if (regular_enemy_count_ >= MAX_ENEMIES_PER_TYPE) {
+    if (regular_enemy_count_ >= max_enemies_per_type_) {
         return nullptr;
     }
 
@@ -1106,8 +1138,8 @@ EnemyGameObject* Game::CreateEnemy(const glm::vec3& position) {
     enemy->SetProjectileTexture(tex_[tex_enemy_projectile]);
 
     // Set patrol parameters (random ellipse size)
-    float width = 1.0f + ((float)rand() / RAND_MAX) * 2.0f;  // 1.0 to 3.0
-    float height = 1.0f + ((float)rand() / RAND_MAX) * 1.5f; // 1.0 to 2.5
+    float width = Random::Range(RandomStream::SPAWN, 1.0f, 3.0f);  // 1.0 to 3.0
+    float height = Random::Range(RandomStream::SPAWN, 1.0f, 2.5f); // 1.0 to 2.5
     enemy->SetPatrolParameters(position, width, height);
 
     // Increment counter
@@ -1123,8 +1155,8 @@ void Game::SpawnAsteroid(int count) {
     for (int i = 0; i < count; i++) {
         // Generate random position
         const float BOUND = 20.0f;
-        float rand_x = ((float)rand() / RAND_MAX) * (2 * BOUND) - BOUND;
-        float rand_y = ((float)rand() / RAND_MAX) * (2 * BOUND) - BOUND;
+        float rand_x = Random::Range(RandomStream::SPAWN, -BOUND, BOUND);
+        float rand_y = Random::Range(RandomStream::SPAWN, -BOUND, BOUND);
 
         Asteroid* asteroid = new Asteroid(
             glm::vec3(rand_x, rand_y, 0.0f),
@@ -1133,8 +1165,7 @@ void Game::SpawnAsteroid(int count) {
             tex_[tex_asteroid]
         );
 
-        // Insert before the background
-        game_objects_.insert(game_objects_.end() - 1, asteroid);
+        entities_.Asteroids().Add(asteroid);
     }
 }
 
@@ -1148,44 +1179,375 @@ void Game::ProcessAsteroidCollisions() {
 
     glm::vec3 player_pos = player->GetPosition();
 
-    // Check for collisions with all asteroids
-    for (int i = 1; i < game_objects_.size() - 1; i++) {
-        Asteroid* asteroid = dynamic_cast<Asteroid*>(game_objects_[i]);
+    float player_radius = player->GetScale().x * 0.4f;
+
+    // Check for collisions with the asteroids near the player
+    collision_grid_.QueryCircle(player_pos, player_radius, [&](const SpatialGrid::Entry& entry) {
+        Asteroid* asteroid = entities_.Asteroids().Get(entry.handle);
         if (asteroid) {
             float distance = glm::length(asteroid->GetPosition() - player_pos);
             float asteroid_radius = asteroid->GetScale().x * 0.4f;
-            float player_radius = player->GetScale().x * 0.4f;
 
             // If distance is less than combined radii, collision occurred
             if (distance < (asteroid_radius + player_radius)) {
                 asteroid->CollisionWithPlayer(player);
             }
         }
+        return true;
+    });
+}
+
+// Rebuild the collision grid from the current entity positions
+void Game::BuildCollisionGrid(void) {
+    collision_grid_.Clear();
+
+    const EntityPool<EnemyGameObject>& enemies = entities_.Enemies();
+    for (size_t i = 0; i < enemies.Size(); i++) {
+        EnemyGameObject* enemy = enemies[i];
+        if (enemy->IsActive() && !enemy->IsExploding()) {
+            // Heavy enemies have a larger hit box
+            float radius = (enemy->GetEnemyType() == 2) ? 1.2f : 0.8f;
+            collision_grid_.Insert(enemies.HandleAt(i), enemy->GetPosition(), radius);
+        }
+    }
+
+    const EntityPool<CollectibleGameObject>& collectibles = entities_.Collectibles();
+    for (size_t i = 0; i < collectibles.Size(); i++) {
+        CollectibleGameObject* collectible = collectibles[i];
+        if (collectible->IsActive() && !collectible->IsExploding() && !collectible->IsCollected()) {
+            collision_grid_.Insert(collectibles.HandleAt(i), collectible->GetPosition(), 0.8f);
+        }
+    }
+
+    const EntityPool<Asteroid>& asteroids = entities_.Asteroids();
+    for (size_t i = 0; i < asteroids.Size(); i++) {
+        Asteroid* asteroid = asteroids[i];
+        collision_grid_.Insert(asteroids.HandleAt(i), asteroid->GetPosition(), asteroid->GetScale().x * 0.4f);
+    }
+
+    // The boss goes in as its base (part 0) plus one entry per arm part
+    BossGameObject* boss = GetBoss();
+    if (boss && boss->IsActive() && !boss->IsExploding()) {
+        collision_grid_.Insert(boss_, boss->GetPosition(), 1.5f, 0);
+
+        std::vector<glm::vec3> arm_positions = boss->GetArmPositions();
+        std::vector<float> arm_radii = boss->GetArmRadii();
+        if (arm_positions.size() == arm_radii.size()) {
+            for (size_t i = 0; i < arm_positions.size(); i++) {
+                collision_grid_.Insert(boss_, arm_positions[i], arm_radii[i], static_cast<int>(i) + 1);
+            }
+        }
+    }
+
+    collision_grid_.Build();
+}
+
+
+// Update every active object in a pool
+template <typename T>
+static void UpdatePool(const EntityPool<T>& pool, double delta_time) {
+    // Index loop: updates may spawn new objects into the pool
+    for (size_t i = 0; i < pool.Size(); i++) {
+        if (pool[i]->IsActive()) {
+            pool[i]->Update(delta_time);
+        }
     }
 }
 
+void Game::ProcessPlayerCollisions(PlayerGameObject* player) {
+    // Only collectibles and enemies near the player are checked
+    collision_grid_.QueryCircle(player->GetPosition(), 0.8f, [&](const SpatialGrid::Entry& entry) {
+        if (entry.handle.kind == EntityKind::COLLECTIBLE) {
+            ProcessPlayerCollectibleCollision(player, entities_.Collectibles().Get(entry.handle));
+        }
+        else if (entry.handle.kind == EntityKind::ENEMY) {
+            ProcessPlayerEnemyCollision(player, entities_.Enemies().Get(entry.handle));
+        }
+        return true;
+    });
+}
+
+void Game::ProcessPlayerCollectibleCollision(PlayerGameObject* player, CollectibleGameObject* collectible) {
+    // Skip removed, inactive or exploding objects
+    if (!collectible || !collectible->IsActive() || collectible->IsExploding()) {
+        return;
+    }
+
+    // Calculate distance for simple circle-circle collision
+    float distance = glm::length(player->GetPosition() - collectible->GetPosition());
+
+    // Collision threshold check
+    if (distance < 0.8f && !collectible->IsCollected()) {
+        collectible->Collect();
+        Type type = collectible->GetType(); // Get the type
+        bool became_invincible = player->CollectItem(type); // Pass the type
+
+        // Play appropriate sound effect
+        if (became_invincible) {
+            audio_system_.PlaySound(invincible_start_sound_, SOUND_PICKUP);
+        }
+        else {
+            audio_system_.PlaySound(pickup_sound_, SOUND_PICKUP);
+        }
+
+        // Spawn new collectible
+        SpawnCollectibles(1);
+        std::cout << "Collectible obtained!" << std::endl;
+    }
+}
+
+void Game::ProcessPlayerEnemyCollision(PlayerGameObject* player, EnemyGameObject* enemy) {
+    // Skip removed, inactive or exploding objects
+    if (!enemy || !enemy->IsActive() || enemy->IsExploding()) {
+        return;
+    }
+
+    // Calculate distance for simple circle-circle collision
+    float distance = glm::length(player->GetPosition() - enemy->GetPosition());
+
+    // Collision threshold check
+    if (distance < 0.8f) {
+        if (player->IsInvincible()) {
+            // While invincible, we still explode the enemy but don't take damage
+            enemy->StartExplosion();
+            enemy->SetScale(2.5f);  // Make explosion bigger
+            audio_system_.PlaySoundAt(explosion_sound_, SOUND_EXPLOSION, enemy->GetPosition());
+            std::cout << "Enemy destroyed while invincible!" << std::endl;
+        }
+        else {
+            // Regular collision handling when not invincible
+            enemy->StartExplosion();
+            enemy->SetScale(2.5f);  // Make explosion bigger
+
+            // Apply damage to player
+            player->TakeDamage(1.0f);
+
+            // If player is now exploding, scale up their explosion too
+            if (player->IsExploding()) {
+                player->SetScale(2.5f);
+            }
+
+            // Play explosion sound
+            audio_system_.PlaySoundAt(explosion_sound_, SOUND_EXPLOSION, enemy->GetPosition());
+        }
+    }
+}
+
+void Game::ProcessProjectileCollisions(Projectile* projectile, PlayerGameObject* player, double delta_time) {
+    if (projectile->IsExpired()) {
+        return;
+    }
+
+    // Process projectile collisions with enemies
+    if (!projectile->IsEnemyProjectile()) {
+        // Check this projectile against the enemies along its path
+        float ray_length = projectile->GetSpeed() * delta_time * 2.0f;
+        collision_grid_.QuerySegment(projectile->GetPosition(), projectile->GetDirection(), ray_length,
+            [&](const SpatialGrid::Entry& entry) {
+                EnemyGameObject* enemy = entities_.Enemies().Get(entry.handle);
+
+                // Only process active, non-exploding enemies
+                if (enemy && enemy->IsActive() && !enemy->IsExploding()) {
+                    // Process ray-circle collision between projectile and enemy
+                    ProcessProjectileEnemyCollisions(projectile, enemy, delta_time);
+
+                    // If projectile was deactivated by collision, stop checking other enemies
+                    return projectile->IsActive();
+                }
+                return true;
+            });
+        BossGameObject* boss = GetBoss();
+        if (current_level_ == 2 && boss && projectile->IsActive() && boss->IsActive() && !boss->IsExploding()){
+            ProcessBossProjectileCollisions(projectile, boss, delta_time);
+        }
+        return;
+    }
+
+    // Process enemy projectile collisions with player
+    if (player && player->IsActive()) {
+        // Get player position and radius for collision detection
+        glm::vec3 player_pos = player->GetPosition();
+        float player_radius = 0.8f; // Match the collision radius used for enemies
+
+        // Get projectile data for ray-circle collision
+        glm::vec3 projectile_pos = projectile->GetPosition();
+        glm::vec3 projectile_dir = projectile->GetDirection();
+        float ray_length = projectile->GetSpeed() * delta_time * 2.0f;
+
+        // Check for collision between enemy projectile and player
+        if (CollisionDetection::RayCircleIntersection(
+            projectile_pos,
+            projectile_dir,
+            ray_length,
+            player_pos,
+            player_radius)) {
+
+            // Only apply damage if player is not invincible
+            if (!player->IsInvincible()) {
+                player->TakeDamage(1.0f);
+
+                // If player is now exploding, scale up the explosion
+                if (player->IsExploding()) {
+                    player->SetScale(2.5f);
+                }
+
+                // Play hit sound
+                audio_system_.PlaySoundAt(hit_sound_, SOUND_HIT, player->GetPosition());
+            }
+            else {
+                // Player is invincible - show message
+                std::cout << "Projectile deflected by invincibility shield!" << std::endl;
+            }
+
+            // Deactivate projectile regardless of player invincibility
+            projectile->SetActive(false);
+        }
+    }
+}
 
 // Update method to handle game logic
-void Game::Update(double delta_time) {
+void Game::ThinkEnemy(EnemyGameObject* enemy, size_t index, const PlayerGameObject* player,
+    std::vector<EnemyFireCommand>& fire_queue) const {
+    if (!enemy->IsActive() || enemy->IsExploding()) {
+        return;
+    }
+    glm::vec3 player_pos = player->GetPosition();
+
+    // Calculate distance to player
+    float distance = glm::length(enemy->GetPosition() - player_pos);
+
+    // Update enemy target and state based on player proximity
+    // Use the enemy's specific detection range
+    if (distance < enemy->GetDetectionRange()) {
+        // If within firing range, set to ATTACKING state
+        if (distance < enemy->GetDetectionRange() * 0.7f) {
+            enemy->SetState(EnemyState::ATTACKING);
+        }
+        else {
+            enemy->SetState(EnemyState::INTERCEPTING);
+        }
+
+        // Add slight prediction to player position for more challenging gameplay
+        glm::vec3 predicted_pos = player_pos + player->GetVelocity() * 0.5f;
+        enemy->SetTarget(predicted_pos);
+
+        // Handle enemy firing when in ATTACKING state
+        if (enemy->GetState() == EnemyState::ATTACKING && enemy->CanAttack()) {
+            // Get the enemy type
+            int enemy_type = enemy->GetEnemyType();
+
+            // Get enemy's position and rotation
+            glm::vec3 enemy_pos = enemy->GetPosition();
+            float enemy_rotation = enemy->GetRotation();
+
+            // Calculate enemy's forward vector based on its rotation
+            glm::vec3 enemy_forward(cos(enemy_rotation), sin(enemy_rotation), 0.0f);
+
+            // Slightly adjust spawn position to be at the front of the ship
+            // The projectiles are created on the main thread, see UpdateEnemyAI
+            EnemyFireCommand command;
+            command.enemy = index;
+            command.position = enemy_pos + enemy_forward * 0.5f;
+            command.rotation = enemy_rotation;
+            command.enemy_type = enemy_type;
+            fire_queue.push_back(command);
+
+            // Reset attack cooldown based on enemy type
+            float cooldown = 2.0f;  // Default cooldown
+            if (enemy_type == 1) {  // Fast enemy
+                cooldown = 0.8f;
+            }
+            else if (enemy_type == 2) {  // Heavy enemy
+                cooldown = 3.0f;
+            }
+
+            enemy->ResetAttackCooldown(cooldown);
+        }
+    }
+    else if (enemy->GetState() == EnemyState::INTERCEPTING) {
+        // Return to patrol if player is out of range
+        if (distance > enemy->GetDetectionRange() * 1.5f) {
+            enemy->SetState(EnemyState::PATROLLING);
+        }
+        else {
+            // Update target position while still intercepting
+            enemy->SetTarget(player_pos);
+        }
+    }
+}
+
+void Game::UpdateEnemyAI(PlayerGameObject* player) {
+    PROFILE_ZONE("Enemy AI");
+
+    // One queue per thread, so thinking needs no locks
+    fire_queues_.resize(JobSystem::GetThreadCount());
+    for (std::vector<EnemyFireCommand>& queue : fire_queues_) {
+        queue.clear();
+    }
+
+    const EntityPool<EnemyGameObject>& enemies = entities_.Enemies();
+    JobSystem::ParallelFor(enemies.Size(), enemy_job_grain_g, [&](size_t begin, size_t end, int thread) {
+        for (size_t i = begin; i < end; i++) {
+            ThinkEnemy(enemies[i], i, player, fire_queues_[thread]);
+        }
+    });
+
+    // Fire in enemy order whatever thread decided the shot, so the
+    // projectiles are created in the same order as a serial update would
+    fire_commands_.clear();
+    for (const std::vector<EnemyFireCommand>& queue : fire_queues_) {
+        fire_commands_.insert(fire_commands_.end(), queue.begin(), queue.end());
+    }
+    std::sort(fire_commands_.begin(), fire_commands_.end(),
+        [](const EnemyFireCommand& a, const EnemyFireCommand& b) { return a.enemy < b.enemy; });
+
+    for (const EnemyFireCommand& command : fire_commands_) {
+        glm::vec3 enemy_forward(cos(command.rotation), sin(command.rotation), 0.0f);
+
+        if (command.enemy_type == 0) {  // Regular enemy - shotgun pattern
+            // Create a 180-degree spread (π radians)
+            float spread_angle = glm::pi<float>();
+
+            // Fire 5 bullets in the spread pattern
+            for (int i = 0; i < 5; i++) {
+                // Calculate angle for each projectile in the spread
+                // This maps i=0 to -spread/2, i=2 to 0, and i=4 to +spread/2
+                float angle_offset = spread_angle * (i / 4.0f - 0.5f);
 
-    static int debug_counter = 0;
-    if (debug_counter++ % 60 == 0) {
-        std::cout << "DEBUG: Level=" << current_level_ 
-                << ", EnemyCount=" << (enemy_count_ ? enemy_count_->GetCount() : -1)
-                << ", TransitioningFlag=" << transitioning_to_level2_ << std::endl;
+                // Calculate the final direction for this projectile
+                float projectile_angle = command.rotation + angle_offset;
+                glm::vec3 projectile_direction(cos(projectile_angle), sin(projectile_angle), 0.0f);
+
+                // Create the projectile with the calculated direction
+                CreateEnemyProjectile(command.position, projectile_direction, command.enemy_type);
+            }
+        }
+        else {
+            // Fast or heavy enemy - single projectile
+            // Use enemy's forward direction for accurate firing
+            CreateEnemyProjectile(command.position, enemy_forward, command.enemy_type);
+        }
     }
+}
+
+void Game::Update(double delta_time) {
+    PROFILE_ZONE("Update");
 
     if (game_over_) {
-        for (auto obj : game_objects_) {
+        entities_.ForEach([delta_time](GameObject* obj) {
             if (obj->IsActive()) {
                 obj->Update(delta_time);
             }
-        }
+        });
         return;
     }
 
+    // One broadphase build serves every collision pass of this tick
+    BuildCollisionGrid();
+
     // Add boss-player collision detection when boss exists
-    if (boss_ && boss_->IsActive() && !boss_->IsExploding()) {
+    BossGameObject* boss = GetBoss();
+    if (boss && boss->IsActive() && !boss->IsExploding()) {
         ProcessBossPlayerCollision(delta_time);
     }
 
@@ -1194,35 +1556,25 @@ void Game::Update(double delta_time) {
         return;
     }
 
-    if (current_level_ == 2 && enemy_count_ && enemy_count_->GetCount() >= 5 && !boss_) {
+    if (current_level_ == 2 && enemy_count_ && enemy_count_->GetCount() >= 5 && !boss_.IsSet()) {
         SpawnBoss();
+        boss = GetBoss();
         std::cout << "Boss spawned after defeating 5 enemies in level 2!" << std::endl;
     }
 
-    // Cast first object to PlayerGameObject (it's always the player)
-    PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(game_objects_[0]);
+    PlayerGameObject* player = GetPlayer();
 
-    GameTimer* time_obj = nullptr;
-    EnemyCounter* enemy_counter = nullptr;
+    GameTimer* time_obj = time_ui_;
+    EnemyCounter* enemy_counter = enemy_count_;
 
     if (player && player->IsExploding()) {
         GameOver("Player destroyed! Game over. You lose.");
     }
 
-    if (boss_ && boss_->IsExploding() && boss_->GetPhase() == Phase::DEFEATED && enemy_count_->GetCount() == 5) {
+    if (boss && boss->IsExploding() && boss->GetPhase() == Phase::DEFEATED && enemy_count_->GetCount() == 5) {
         GameOver("Boss defeated! You win!");
     }
 
-    for(int i = 1; i < game_objects_.size() - 1; i++) {
-        if(!time_obj) {
-            time_obj = dynamic_cast<GameTimer*>(game_objects_[i]);
-        }
-        if(!enemy_counter) {
-            enemy_counter = dynamic_cast<EnemyCounter*>(game_objects_[i]);
-        }
-        if(time_obj && enemy_counter) break;
-    }
-
     if(player && time_obj) {
         glm::vec3 player_pos = player->GetPosition();
         
@@ -1237,13 +1589,7 @@ void Game::Update(double delta_time) {
         enemy_counter->SetPosition(counter_pos);
     }
 
-    // if(current_level_ == 1 || (current_level_ == 2 && !boss_)){
-        // Check enemy spawn timer and spawn if needed
-        if (enemy_spawn_timer_.Finished()) {
-            SpawnEnemy();
-            enemy_spawn_timer_.Start(5.0f); // Reset timer for next spawn (every 5 seconds)
-        }
-    // }
+    // Enemies spawn from a callback on the game clock, see ScheduleEnemySpawn
 
     // if(current_level_ == 2 && boss_ && boss_->IsActive() && !boss_->IsExploding()){
     //     if (boss_->CanProjectiles()) {
@@ -1268,7 +1614,7 @@ void Game::Update(double delta_time) {
     //     }
     // }
 
-    if(boss_){
+    if(boss){
         UpdateBoss(delta_time);
     }
 
@@ -1278,7 +1624,7 @@ void Game::Update(double delta_time) {
     // Check if player fired a weapon
     if (player && player->IsActive() && !player->IsExploding()) {
         // Check for firing when the space key is pressed
-        bool space_pressed = glfwGetKey(window_, GLFW_KEY_SPACE) == GLFW_PRESS;
+        bool space_pressed = (input_ & INPUT_FIRE) != 0;
 
         if (space_pressed) {
             // Handle different weapon types
@@ -1307,268 +1653,92 @@ void Game::Update(double delta_time) {
 
     // Check if invincibility just ended
     if (player && player->IsInvincible() && player->GetInvincibilityTimer().Finished()) {
-        audio_system_.PlaySound(invincible_end_sound_);
+        audio_system_.PlaySound(invincible_end_sound_, SOUND_PICKUP);
     }
 
     // Update enemy states based on player position with improved logic
     if (player && player->IsActive()) {
-        glm::vec3 player_pos = player->GetPosition();
-
-        for (int i = 1; i < game_objects_.size() - 1; i++) {
-            EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(game_objects_[i]);
-            if (enemy && enemy->IsActive() && !enemy->IsExploding()) {
-                // Calculate distance to player
-                float distance = glm::length(enemy->GetPosition() - player_pos);
-
-                // Update enemy target and state based on player proximity
-                // Use the enemy's specific detection range
-                if (distance < enemy->GetDetectionRange()) {
-                    // If within firing range, set to ATTACKING state
-                    if (distance < enemy->GetDetectionRange() * 0.7f) {
-                        enemy->SetState(EnemyState::ATTACKING);
-                    }
-                    else {
-                        enemy->SetState(EnemyState::INTERCEPTING);
-                    }
-
-                    // Add slight prediction to player position for more challenging gameplay
-                    glm::vec3 predicted_pos = player_pos + player->GetVelocity() * 0.5f;
-                    enemy->SetTarget(predicted_pos);
-
-                    // Handle enemy firing when in ATTACKING state
-                    if (enemy->GetState() == EnemyState::ATTACKING && enemy->CanAttack()) {
-                        // Get the enemy type
-                        int enemy_type = enemy->GetEnemyType();
-
-                        // Get enemy's position and rotation
-                        glm::vec3 enemy_pos = enemy->GetPosition();
-                        float enemy_rotation = enemy->GetRotation();
-
-                        // Calculate enemy's forward vector based on its rotation
-                        glm::vec3 enemy_forward(cos(enemy_rotation), sin(enemy_rotation), 0.0f);
-
-                        // Slightly adjust spawn position to be at the front of the ship
-                        glm::vec3 firing_position = enemy_pos + enemy_forward * 0.5f;
-
-                        if (enemy_type == 0) {  // Regular enemy - shotgun pattern
-                            // Create a 180-degree spread (π radians)
-                            float spread_angle = glm::pi<float>();
-
-                            // Fire 5 bullets in the spread pattern
-                            for (int i = 0; i < 5; i++) {
-                                // Calculate angle for each projectile in the spread
-                                // This maps i=0 to -spread/2, i=2 to 0, and i=4 to +spread/2
-                                float angle_offset = spread_angle * (i / 4.0f - 0.5f);
-
-                                // Calculate the final direction for this projectile
-                                float projectile_angle = enemy_rotation + angle_offset;
-                                glm::vec3 projectile_direction(cos(projectile_angle), sin(projectile_angle), 0.0f);
-
-                                // Create the projectile with the calculated direction
-                                CreateEnemyProjectile(firing_position, projectile_direction, enemy_type);
-                            }
-                        }
-                        else {
-                            // Fast or heavy enemy - single projectile
-                            // Use enemy's forward direction for accurate firing
-                            CreateEnemyProjectile(firing_position, enemy_forward, enemy_type);
-                        }
-
-                        // Reset attack cooldown based on enemy type
-                        float cooldown = 2.0f;  // Default cooldown
-                        if (enemy_type == 1) {  // Fast enemy
-                            cooldown = 0.8f;
-                        }
-                        else if (enemy_type == 2) {  // Heavy enemy
-                            cooldown = 3.0f;
-                        }
-
-                        enemy->ResetAttackCooldown(cooldown);
-                    }
-                }
-                else if (enemy->GetState() == EnemyState::INTERCEPTING) {
-                    // Return to patrol if player is out of range
-                    if (distance > enemy->GetDetectionRange() * 1.5f) {
-                        enemy->SetState(EnemyState::PATROLLING);
-                    }
-                    else {
-                        // Update target position while still intercepting
-                        enemy->SetTarget(player_pos);
-                    }
-                }
-            }
-        }
+        UpdateEnemyAI(player);
     }
 
-    // Main game object update loop
-    for (int i = 0; i < game_objects_.size(); i++) {
-        GameObject* current_game_object = game_objects_[i];
+    // Main game object update loop, one pass per kind
+    // The player goes first and resolves its contacts before anything else moves
+    ProfileZone objects_zone("Objects and collisions");
+    if (player && player->IsActive()) {
+        player->Update(delta_time);
 
-        // Skip processing for inactive objects
-        if (!current_game_object->IsActive()) {
-            continue;
+        // Skip collision detection if the player is already exploding
+        if (!player->IsExploding()) {
+            ProcessPlayerCollisions(player);
         }
+    }
 
-        // Update current object's state (movement, timers, etc.)
-        current_game_object->Update(delta_time);
+    UpdatePool(entities_.Texts(), delta_time);
+    UpdatePool(entities_.Effects(), delta_time);
+    UpdatePool(entities_.Asteroids(), delta_time);
+    UpdatePool(entities_.Collectibles(), delta_time);
+    // Enemies only move themselves, so they steer in parallel
+    const EntityPool<EnemyGameObject>& enemies = entities_.Enemies();
+    JobSystem::ParallelFor(enemies.Size(), enemy_job_grain_g, [&enemies, delta_time](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; i++) {
+            if (enemies[i]->IsActive()) {
+                enemies[i]->Update(delta_time);
+            }
+        }
+    });
+    UpdatePool(entities_.Bosses(), delta_time);
 
-        // Skip collision detection for objects that are already exploding
-        if (current_game_object->IsExploding()) {
+    // Projectiles and homing missiles check their collisions right after moving
+    for (size_t i = 0; i < entities_.Projectiles().Size(); i++) {
+        Projectile* projectile = entities_.Projectiles()[i];
+        if (!projectile->IsActive()) {
             continue;
         }
-
-        // Process projectile collisions with enemies
-        Projectile* projectile = dynamic_cast<Projectile*>(current_game_object);
-        if (projectile && !projectile->IsExpired() && !projectile->IsEnemyProjectile()) {
-            // Check this projectile against all enemies
-            for (int j = 1; j < game_objects_.size() - 1; j++) {
-                // Skip comparing the projectile with itself
-                if (i == j) continue;
-
-                // Try to cast to an enemy
-                EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(game_objects_[j]);
-
-                // Only process active, non-exploding enemies
-                if (enemy && enemy->IsActive() && !enemy->IsExploding()) {
-                    // Process ray-circle collision between projectile and enemy
-                    ProcessProjectileEnemyCollisions(projectile, enemy, delta_time);
-
-                    // If projectile was deactivated by collision, stop checking other enemies
-                    if (!projectile->IsActive()) break;
-                }
-            }
-            if (current_level_ == 2 && boss_ && projectile->IsActive() && boss_->IsActive() && !boss_->IsExploding()){
-                ProcessBossProjectileCollisions(projectile, boss_, delta_time);
-            }
+        projectile->Update(delta_time);
+        if (projectile->IsActive() && !projectile->IsExploding()) {
+            ProcessProjectileCollisions(projectile, player, delta_time);
         }
-
-        // Process enemy projectile collisions with player
-        if (projectile && !projectile->IsExpired() && projectile->IsEnemyProjectile() && player && player->IsActive()) {
-            // Get player position and radius for collision detection
-            glm::vec3 player_pos = player->GetPosition();
-            float player_radius = 0.8f; // Match the collision radius used for enemies
-
-            // Get projectile data for ray-circle collision
-            glm::vec3 projectile_pos = projectile->GetPosition();
-            glm::vec3 projectile_dir = projectile->GetDirection();
-            float ray_length = projectile->GetSpeed() * delta_time * 2.0f;
-
-            // Check for collision between enemy projectile and player
-            if (CollisionDetection::RayCircleIntersection(
-                projectile_pos,
-                projectile_dir,
-                ray_length,
-                player_pos,
-                player_radius)) {
-
-                // Only apply damage if player is not invincible
-                if (!player->IsInvincible()) {
-                    player->TakeDamage(1.0f);
-
-                    // If player is now exploding, scale up the explosion
-                    if (player->IsExploding()) {
-                        player->SetScale(2.5f);
-                    }
-
-                    // Play hit sound
-                    audio_system_.PlaySound(hit_sound_);
-                }
-                else {
-                    // Player is invincible - show message
-                    std::cout << "Projectile deflected by invincibility shield!" << std::endl;
-                }
-
-                // Deactivate projectile regardless of player invincibility
-                projectile->SetActive(false);
-            }
+    }
+    RetargetMissiles();
+    for (size_t i = 0; i < entities_.HomingMissiles().Size(); i++) {
+        HomingMissile* missile = entities_.HomingMissiles()[i];
+        if (!missile->IsActive()) {
+            continue;
         }
-
-        // Player collisions (player is always index 0)
-        if (i == 0) {
-            // Check against all other objects
-            for (int j = 1; j < game_objects_.size() - 1; j++) {
-                GameObject* other_object = game_objects_[j];
-
-                // Skip inactive or exploding objects
-                if (!other_object->IsActive() || other_object->IsExploding()) {
-                    continue;
-                }
-
-                // Calculate distance for simple circle-circle collision
-                float distance = glm::length(player->GetPosition() - other_object->GetPosition());
-
-                // Collision threshold check
-                if (distance < 0.8f) {
-                    // Check if it's a collectible
-                    CollectibleGameObject* collectible = dynamic_cast<CollectibleGameObject*>(other_object);
-                    if (collectible && !collectible->IsCollected()) {
-                        collectible->Collect();
-                        Type type = collectible->GetType(); // Get the type
-                        bool became_invincible = player->CollectItem(type); // Pass the type
-
-                        // Play appropriate sound effect
-                        if (became_invincible) {
-                            audio_system_.PlaySound(invincible_start_sound_);
-                        }
-                        else {
-                            audio_system_.PlaySound(pickup_sound_);
-                        }
-
-                        // Spawn new collectible
-                        SpawnCollectibles(1);
-                        std::cout << "Collectible obtained!" << std::endl;
-                    }
-                    // Check if it's an enemy
-                    else if (dynamic_cast<EnemyGameObject*>(other_object)) {
-                        if (player->IsInvincible()) {
-                            // While invincible, we still explode the enemy but don't take damage
-                            other_object->StartExplosion();
-                            other_object->SetScale(2.5f);  // Make explosion bigger
-                            audio_system_.PlaySound(explosion_sound_);
-                            std::cout << "Enemy destroyed while invincible!" << std::endl;
-                        }
-                        else {
-                            // Regular collision handling when not invincible
-                            other_object->StartExplosion();
-                            other_object->SetScale(2.5f);  // Make explosion bigger
-
-                            // Apply damage to player
-                            player->TakeDamage(1.0f);
-
-                            // If player is now exploding, scale up their explosion too
-                            if (player->IsExploding()) {
-                                player->SetScale(2.5f);
-                            }
-
-                            // Play explosion sound
-                            audio_system_.PlaySound(explosion_sound_);
-                        }
-                    }
-                }
-            }
+        missile->Update(delta_time);
+        if (missile->IsActive() && !missile->IsExploding()) {
+            ProcessProjectileCollisions(missile, player, delta_time);
         }
     }
 
-    // Cleanup loop - remove inactive objects
-    // Skip player (i=0) and background (last object)
-    for (int i = 1; i < game_objects_.size() - 1; i++) {
-        if (!game_objects_[i]->IsActive()) {
-            // Check enemy type and decrement appropriate counter
-            EnemyGameObject* enemy = dynamic_cast<EnemyGameObject*>(game_objects_[i]);
-            if (enemy) {
-                int type = enemy->GetEnemyType();
-                if (type == 0) regular_enemy_count_--;
-                else if (type == 1) fast_enemy_count_--;
-                else if (type == 2) heavy_enemy_count_--;
-            }
+    // Flames follow their missiles, so they update last
+    flame_emitter_.Update(delta_time);
 
-            delete game_objects_[i];
-            game_objects_.erase(game_objects_.begin() + i);
-            i--; // Adjust index since we removed an element
-        }
+    if (background_) {
+        background_->Update(delta_time);
     }
+
+    objects_zone.End();
+
+    // Cleanup loop - remove inactive objects
+    PROFILE_ZONE("Cleanup");
+    // The player, UI text and effects are referenced directly and are never removed
+    entities_.Enemies().RemoveInactive([this](EnemyGameObject* enemy) {
+        // Check enemy type and decrement appropriate counter
+        int type = enemy->GetEnemyType();
+        if (type == 0) regular_enemy_count_--;
+        else if (type == 1) fast_enemy_count_--;
+        else if (type == 2) heavy_enemy_count_--;
+    });
+    entities_.Projectiles().RemoveInactive();
+    entities_.HomingMissiles().RemoveInactive();
+    entities_.Collectibles().RemoveInactive();
+    entities_.Asteroids().RemoveInactive();
+    entities_.Bosses().RemoveInactive();
 }
 void Game::RenderUI() {
+    PROFILE_ZONE("RenderUI");
+
     // Get player for health information
     PlayerGameObject* player = GetPlayer();
     if (!player || !player->IsActive()) return;
@@ -1579,6 +1749,8 @@ void Game::RenderUI() {
 
     // CRITICAL: Create a completely separate rendering context for UI
     // Clear depth buffer only (keep color from main rendering)
+    // Depth writes must be on for the clear to reach the depth buffer
+    RenderState::Opaque().Apply();
     glClear(GL_DEPTH_BUFFER_BIT);
 
     // Set up fresh 2D orthographic projection
@@ -1589,9 +1761,7 @@ void Game::RenderUI() {
     );
 
     // Setup rendering state
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    RenderState::Overlay().Apply();
 
     // Render health bar - make it SIGNIFICANTLY larger
     if (health_bar_.IsInitialized()) {
@@ -1610,19 +1780,249 @@ void Game::RenderUI() {
         float health = player->GetHealth() / 20.0f;
         health_bar_.Render(ui_projection, health);
     }
-
-    // Restore rendering state
-    glEnable(GL_DEPTH_TEST);
-    glDisable(GL_BLEND);
 }
 
 // Modify Game::Render method to add minimap rendering at the end:
 
-void Game::Render(void) {
+void Game::SaveTransforms(void) {
+    entities_.ForEach([](GameObject* obj) {
+        obj->SaveTransform();
+    });
+    if (background_) {
+        background_->SaveTransform();
+    }
+}
+
+
+PlayerInput Game::SampleInput(void) const {
+    PlayerInput input = 0;
+    if (glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS) input |= INPUT_FORWARD;
+    if (glfwGetKey(window_, GLFW_KEY_S) == GLFW_PRESS) input |= INPUT_BACKWARD;
+    if (glfwGetKey(window_, GLFW_KEY_A) == GLFW_PRESS) input |= INPUT_TURN_LEFT;
+    if (glfwGetKey(window_, GLFW_KEY_D) == GLFW_PRESS) input |= INPUT_TURN_RIGHT;
+    if (glfwGetKey(window_, GLFW_KEY_Z) == GLFW_PRESS) input |= INPUT_STRAFE_LEFT;
+    if (glfwGetKey(window_, GLFW_KEY_C) == GLFW_PRESS) input |= INPUT_STRAFE_RIGHT;
+    if (glfwGetKey(window_, GLFW_KEY_SPACE) == GLFW_PRESS) input |= INPUT_FIRE;
+    if (glfwGetKey(window_, GLFW_KEY_Q) == GLFW_PRESS) input |= INPUT_SWITCH_WEAPON;
+    return input;
+}
+
+
+void Game::HandleFrameControls(void) {
+    if (glfwGetKey(window_, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+        glfwSetWindowShouldClose(window_, true);
+    }
+
+    // F4 toggles the render stats
+    static bool f4_pressed = false;
+    if (glfwGetKey(window_, GLFW_KEY_F4) == GLFW_PRESS) {
+        if (!f4_pressed) {
+            show_render_stats_ = !show_render_stats_;
+            if (!show_render_stats_) {
+                glfwSetWindowTitle(window_, window_title_g);
+            }
+            f4_pressed = true;
+        }
+    }
+    else {
+        f4_pressed = false;
+    }
+
+    // F3 toggles the profile table
+    static bool f3_pressed = false;
+    if (glfwGetKey(window_, GLFW_KEY_F3) == GLFW_PRESS) {
+        if (!f3_pressed) {
+            show_profile_ = !show_profile_;
+            f3_pressed = true;
+        }
+    }
+    else {
+        f3_pressed = false;
+    }
+
+    // P pauses, F toggles fast-forward
+    static bool p_pressed = false;
+    if (glfwGetKey(window_, GLFW_KEY_P) == GLFW_PRESS) {
+        if (!p_pressed) {
+            GameClock::SetPaused(!GameClock::IsPaused());
+            p_pressed = true;
+        }
+    }
+    else {
+        p_pressed = false;
+    }
+
+    static bool f_pressed = false;
+    if (glfwGetKey(window_, GLFW_KEY_F) == GLFW_PRESS) {
+        if (!f_pressed) {
+            GameClock::SetTimeScale(GameClock::GetTimeScale() > 1.0 ? 1.0 : 4.0);
+            f_pressed = true;
+        }
+    }
+    else {
+        f_pressed = false;
+    }
+}
+
+
+void Game::ShowRenderStats(void) {
+    // The title bar summary changes a few times a second, the full table
+    // goes to the console once per profile window
+    uint64_t frame = Profiler::GetFrameCount();
+    if (frame % 30 == 0) {
+        std::ostringstream title;
+        title << window_title_g << " | GPU ";
+        double gpu_ms = RenderStats::GetGpuFrameMs();
+        if (gpu_ms < 0.0) {
+            title << "n/a";
+        }
+        else {
+            title << std::fixed << std::setprecision(2) << gpu_ms << " ms";
+        }
+        title << " | " << RenderStats::GetDrawCount() << " draws";
+        glfwSetWindowTitle(window_, title.str().c_str());
+    }
+    if (frame % Profiler::GetHistoryLength() == 0) {
+        RenderStats::PrintTable(std::cout);
+    }
+}
+
+
+void Game::MaintainStressLoad(const StressLoad& load) {
+    const float BOUND = 20.0f;
+
+    // Enemies of a random type, as SpawnEnemy would pick
+    int missing = load.enemies - static_cast<int>(entities_.Enemies().Size());
+    for (int i = 0; i < missing; i++) {
+        glm::vec3 position(Random::Range(RandomStream::SPAWN, -BOUND, BOUND),
+            Random::Range(RandomStream::SPAWN, -BOUND, BOUND), 0.0f);
+        // Fall back to the other types when one is at its limit
+        EnemyGameObject* enemy = nullptr;
+        int type = Random::Index(RandomStream::SPAWN, 3);
+        for (int tries = 0; tries < 3 && !enemy; tries++, type = (type + 1) % 3) {
+            switch (type) {
+            case 0: enemy = CreateEnemy(position); break;
+            case 1: enemy = CreateFastEnemy(position); break;
+            default: enemy = CreateHeavyEnemy(position); break;
+            }
+        }
+        if (!enemy) {
+            break;  // Every type is at its limit
+        }
+        entities_.Enemies().Add(enemy);
+    }
+
+    missing = load.asteroids - static_cast<int>(entities_.Asteroids().Size());
+    if (missing > 0) {
+        SpawnAsteroid(missing);
+    }
+
+    // Shots fly off in every direction from anywhere on the map
+    missing = load.projectiles - static_cast<int>(entities_.Projectiles().Size());
+    for (int i = 0; i < missing; i++) {
+        glm::vec3 position(Random::Range(RandomStream::SPAWN, -BOUND, BOUND),
+            Random::Range(RandomStream::SPAWN, -BOUND, BOUND), 0.0f);
+        float angle = Random::Range(RandomStream::SPAWN, 0.0f, 2.0f * glm::pi<float>());
+        CreateProjectile(position, glm::vec3(cos(angle), sin(angle), 0.0f));
+    }
+
+    missing = load.homing_missiles - static_cast<int>(entities_.HomingMissiles().Size());
+    for (int i = 0; i < missing; i++) {
+        glm::vec3 position(Random::Range(RandomStream::SPAWN, -BOUND, BOUND),
+            Random::Range(RandomStream::SPAWN, -BOUND, BOUND), 0.0f);
+        float angle = Random::Range(RandomStream::SPAWN, 0.0f, 2.0f * glm::pi<float>());
+        CreateHomingMissile(position, glm::vec3(cos(angle), sin(angle), 0.0f));
+    }
+}
+
+
+void Game::RunBenchFrame(const StressLoad& load) {
+    Profiler::BeginFrame();
+    {
+        PROFILE_ZONE("Stress spawn");
+        MaintainStressLoad(load);
+    }
+
+    SaveTransforms();
+    Step(0);
+
+    if (!headless_) {
+        RenderStats::BeginFrame();
+        Render(1.0f);
+        RenderStats::EndFrame();
+
+        // Charge the GPU's work to this frame
+        PROFILE_ZONE("GPU wait");
+        glFinish();
+    }
+    Profiler::EndFrame();
+}
+
+
+void Game::RunScriptedFrame(PlayerInput input) {
+    Profiler::BeginFrame();
+    SaveTransforms();
+    Step(input);
+
+    if (!headless_) {
+        Render(1.0f);
+    }
+    Profiler::EndFrame();
+}
+
+
+uint64_t Game::GetStateDigest(void) const {
+    // FNV-1a over the raw bytes, floats included: a replay must match exactly
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    mix(&step_count_, sizeof(step_count_));
+    mix(&current_level_, sizeof(current_level_));
+    mix(&game_over_, sizeof(game_over_));
+    entities_.ForEach([&mix](GameObject* obj) {
+        EntityKind kind = obj->GetKind();
+        if (kind == EntityKind::EFFECT) {
+            return;
+        }
+        glm::vec3 position = obj->GetPosition();
+        glm::vec2 scale = obj->GetScale();
+        float rotation = obj->GetRotation();
+        mix(&kind, sizeof(kind));
+        mix(&position, sizeof(position));
+        mix(&scale, sizeof(scale));
+        mix(&rotation, sizeof(rotation));
+    });
+    return hash;
+}
+
+
+void Game::SetSimulationRate(double steps_per_second, int max_steps_per_frame) {
+    simulation_step_ = 1.0 / steps_per_second;
+    max_simulation_steps_ = max_steps_per_frame;
+}
+
+
+void Game::Render(float alpha) {
+    PROFILE_ZONE("Render");
+
+    // Place every object between its last two simulation steps
+    entities_.ForEach([alpha](GameObject* obj) {
+        obj->InterpolateTransform(alpha);
+    });
+    if (background_) {
+        background_->InterpolateTransform(alpha);
+    }
+
     // Clear background
     glClearColor(viewport_background_color_g.r,
         viewport_background_color_g.g,
         viewport_background_color_g.b, 0.0);
+    RenderState::Opaque().Apply();  // Depth writes on, or the clear skips the depth buffer
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Get window size for scaling
@@ -1642,9 +2042,9 @@ void Game::Render(void) {
 
     // Get player's position for camera following
     glm::vec3 camera_position(0.0f, 0.0f, 0.0f);
-    PlayerGameObject* player = dynamic_cast<PlayerGameObject*>(game_objects_[0]);
+    PlayerGameObject* player = GetPlayer();
     if (player && player->IsActive()) {
-        camera_position = player->GetPosition();
+        camera_position = player->GetRenderPosition();
     }
 
     // Create camera translation matrix that follows the player
@@ -1657,23 +2057,53 @@ void Game::Render(void) {
     // Combine matrices: window scaling, zoom, and camera translation
     glm::mat4 view_matrix = window_scale_matrix * camera_zoom_matrix * camera_translation;
 
-    // Render all game objects using the final view matrix
-    for (int i = 0; i < game_objects_.size(); i++) {
-        game_objects_[i]->Render(view_matrix, current_time_);
+    // The background goes first without touching the depth buffer, so every
+    // object drawn after covers it and translucent particles blend over it
+    if (background_) {
+        RenderPassScope pass(RenderPass::BACKGROUND);
+        background_->Render(view_matrix, current_time_);
     }
 
+    // Render all game objects using the final view matrix
+    // Plain sprites are batched; the batch is flushed before any object that
+    // draws itself so overlapping objects keep their draw order
+    RenderStats::BeginPass(RenderPass::SPRITES);
+    sprite_batch_.Begin(view_matrix);
+    entities_.ForEach([&](GameObject* obj) {
+        if (!obj->Submit(sprite_batch_)) {
+            sprite_batch_.Flush();
+            obj->Render(view_matrix, current_time_);
+        }
+    });
+    sprite_batch_.Flush();
+    RenderStats::EndPass();
+
+    // Missile flames go on top of the missiles they trail
+    flame_emitter_.Render(view_matrix, current_time_);
+
     // Call the separate UI rendering function
     RenderUI();
 
     // Render the mini map
-    mini_map_.Render(game_objects_, boss_);
+    mini_map_.Render(entities_);
 }
 
 void Game::MainLoop(void)
 {
     // Loop while the user did not close the window
+    // The simulation advances in fixed steps; frames draw objects blended
+    // between the last two steps so motion stays smooth at any refresh rate
     double last_time = glfwGetTime();
+    double accumulator = 0.0;
     while (!glfwWindowShouldClose(window_)){
+        // Leave before the frame is opened, so the profiler sees only
+        // complete frames
+        if (IsMatchOver()) {
+            glfwSetWindowShouldClose(window_, true);
+            break;
+        }
+
+        Profiler::BeginFrame();
 
         // Calculate delta time
         double current_time = glfwGetTime();
@@ -1682,47 +2112,115 @@ void Game::MainLoop(void)
 
         // Update window events like input handling
         glfwPollEvents();
-
-        if (game_over_ && game_over_timer_.Finished()) {
-            glfwSetWindowShouldClose(window_, true);
-            continue;
+        HandleFrameControls();
+
+        // Move the next decoded textures to the GPU; the match is held
+        // until they are all there, while frames keep being drawn
+        if (!texture_loader_.IsDone()) {
+            texture_loader_.Upload(texture_upload_budget_ms_g);
+            if (!texture_loader_.IsDone()) {
+                delta_time = 0.0;
+            }
         }
 
-        // Handle user input
-        HandleControls(delta_time);
+        // Every step of this frame sees the same buttons
+        PlayerInput input = SampleInput();
 
-        // Update all the game objects
-        Update(delta_time);
+        // Game time runs at the clock's pace, and not at all while paused
+        accumulator += GameClock::Scale(delta_time);
 
-		// Update audio system
+        // Run the steps that are due, dropping the backlog if we fall too far
+        // behind rather than spending ever longer catching up
+        int steps = 0;
+        while (accumulator >= simulation_step_) {
+            if (steps == max_simulation_steps_) {
+                accumulator = fmod(accumulator, simulation_step_);
+                break;
+            }
+            SaveTransforms();
+            Step(input);
+            accumulator -= simulation_step_;
+            steps++;
+        }
+
+		// Update audio system, heard from the player
+		PlayerGameObject* listener = GetPlayer();
+		if (listener) {
+			audio_system_.SetListenerPosition(listener->GetPosition());
+		}
 		audio_system_.Update();
 
         // Render all the game objects
-        Render();
+        RenderStats::BeginFrame();
+        Render(static_cast<float>(accumulator / simulation_step_));
+        RenderStats::EndFrame();
 
         // Push buffer drawn in the background onto the display
-        glfwSwapBuffers(window_);
+        {
+            PROFILE_ZONE("SwapBuffers");
+            glfwSwapBuffers(window_);
+        }
+        Profiler::EndFrame();
+
+        // Dump the rolling profile once per history window while enabled
+        if (show_profile_ && Profiler::GetFrameCount() % Profiler::GetHistoryLength() == 0) {
+            Profiler::PrintTable(std::cout);
+        }
+        if (show_render_stats_) {
+            ShowRenderStats();
+        }
     }
+    StopRecording();
 }
 
 
 Game::Game(void)
+    : collision_grid_(40.0f, 2.0f, 0.5f),  // Same world bounds as the mini map
+      // 0 is "no sound"; runs without audio never load them
+      explosion_sound_(0),
+      pickup_sound_(0),
+      invincible_start_sound_(0),
+      invincible_end_sound_(0),
+      fire_sound_(0),
+      enemy_fire_sound_(0),
+      hit_sound_(0)
 {
     // Initialize counters
     regular_enemy_count_ = 0;
     fast_enemy_count_ = 0;
     heavy_enemy_count_ = 0;
+    max_enemies_per_type_ = max_enemies_per_type_g;
+    dust_particle_count_ = dust_particle_count_g;
+    player_immortal_ = false;
+    thread_count_ = 0;
 
     current_level_ = 1;
     level_transition_active_ = false;
-    boss_ = nullptr;
+    window_ = nullptr;
+    headless_ = false;
+    enemy_spawn_event_ = 0;
+    minimap_sprite_ = nullptr;
+    tex_ = nullptr;
+    background_ = nullptr;
+    space_dust_ = nullptr;
+    enemy_count_ = nullptr;
+    time_ui_ = nullptr;
 
     game_over_ = false;
+
+    seed_ = static_cast<uint32_t>(time(nullptr));
+    input_ = 0;
+    previous_input_ = 0;
+    step_count_ = 0;
+    show_profile_ = false;
+    show_render_stats_ = false;
+
+    SetSimulationRate(simulation_rate_g, max_simulation_steps_g);
 }
 
 
 
-void Game::Init(void) {
+void Game::Init(bool visible) {
 
 
     // Initialize the window management library (GLFW)
@@ -1734,6 +2232,7 @@ void Game::Init(void) {
 
     // Set whether window can be resized
     glfwWindowHint(GLFW_RESIZABLE, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GL_TRUE : GL_FALSE);
 
     // Create a window and its OpenGL context
     window_ = glfwCreateWindow(window_width_g, window_height_g, window_title_g, NULL, NULL);
@@ -1753,9 +2252,12 @@ void Game::Init(void) {
             std::string((const char*)glewGetErrorString(err))));
     }
 
+    // GPU timer queries for the render passes
+    RenderStats::Init();
+
     // Initialize dust particle shader
     dust_shader_.Init(
-        (resources_directory_g + std::string("/sprite_vertex_shader.glsl")).c_str(),
+        (resources_directory_g + std::string("/dust_vertex_shader.glsl")).c_str(),
         (resources_directory_g + std::string("/dust_fragment_shader.glsl")).c_str()
     );
 
@@ -1779,6 +2281,11 @@ void Game::Init(void) {
     // Initialize sprite shader
     sprite_shader_.Init((resources_directory_g+std::string("/sprite_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/sprite_fragment_shader.glsl")).c_str());
 
+    // Initialize instanced sprite batch
+    sprite_batch_shader_.Init((resources_directory_g + std::string("/sprite_batch_vertex_shader.glsl")).c_str(),
+        (resources_directory_g + std::string("/sprite_batch_fragment_shader.glsl")).c_str());
+    sprite_batch_.Init(sprite_, &sprite_batch_shader_, &sprite_array_);
+
     // Initialize minimap shader
     minimap_shader_.Init(
         (resources_directory_g + std::string("/minimap_vertex_shader.glsl")).c_str(),
@@ -1789,35 +2296,30 @@ void Game::Init(void) {
     minimap_sprite_ = new MinimapSprite();
     minimap_sprite_->CreateGeometry();
 
-    // Initialize time
-    current_time_ = 0.0;
-
-    current_level_ = 1;
-    transitioning_to_level2_ = false;
-    enemy_kills_ = 0;
+    InitSimulation();
 
-    // Initialize spawn timer
-    enemy_spawn_timer_.Start(10.0f); // Spawn first enemy after 10 seconds
+    // Offscreen benchmarks run silent
+    if (!visible) {
+        return;
+    }
 
-    // Add randomization seed
-    srand(static_cast<unsigned int>(time(nullptr)));
     // Initialize audio system
     try {
         audio_system_.Init();
 
         // Load audio files
         std::string audio_path  = resources_directory_g + "/audio/";
-        background_music_       = audio_system_.LoadSound(audio_path + "background.wav");
-        explosion_sound_        = audio_system_.LoadSound(audio_path + "explosion.wav");
-        pickup_sound_           = audio_system_.LoadSound(audio_path + "RetroPickup10.wav");  
-        invincible_start_sound_ = audio_system_.LoadSound(audio_path + "RetroMagicProtection01.wav");
-        invincible_end_sound_   = audio_system_.LoadSound(audio_path + "RetroChargeOffStereoUP02.wav");
-        fire_sound_ = audio_system_.LoadSound(audio_path + "RetroMissileLauncher01.wav");
-        hit_sound_ = audio_system_.LoadSound(audio_path + "RetroImpactPunch07.wav");
+        audio_system_.LoadSoundBank(sound_bank_file_g);
+        explosion_sound_        = audio_system_.GetSound("explosion.wav");
+        pickup_sound_           = audio_system_.GetSound("RetroPickup10.wav");
+        invincible_start_sound_ = audio_system_.GetSound("RetroMagicProtection01.wav");
+        invincible_end_sound_   = audio_system_.GetSound("RetroChargeOffStereoUP02.wav");
+        fire_sound_ = audio_system_.GetSound("RetroMissileLauncher01.wav");
+        hit_sound_ = audio_system_.GetSound("RetroImpactPunch07.wav");
 
 
         // Start background music
-        audio_system_.PlayBackgroundMusic(background_music_);
+        audio_system_.PlayMusic(audio_path + level1_music_g, 0.0f);
     }
     catch (const std::runtime_error& e) {
         std::cerr << "Audio system initialization failed: " << e.what() << std::endl;
@@ -1827,16 +2329,156 @@ void Game::Init(void) {
 
 
 
+void Game::InitHeadless(void) {
+    headless_ = true;
+
+    // Objects keep a geometry pointer, but nothing is uploaded
+    sprite_ = new Sprite();
+
+    InitSimulation();
+}
+
+
+void Game::InitSimulation(void) {
+    // Initialize time
+    current_time_ = 0.0;
+    GameClock::Reset(0.0);
+
+    current_level_ = 1;
+    transitioning_to_level2_ = false;
+    enemy_kills_ = 0;
+
+    input_ = 0;
+    previous_input_ = 0;
+    step_count_ = 0;
+
+    // Every random stream restarts from the match seed
+    Random::Seed(seed_);
+    std::cout << "Match seed: " << seed_ << std::endl;
+
+    // Workers for the enemy update
+    JobSystem::Init(thread_count_);
+
+    // Initialize spawn timer
+    ScheduleEnemySpawn(10.0); // Spawn first enemy after 10 seconds
+}
+
+
+void Game::SetSeed(uint32_t seed) {
+    seed_ = seed;
+}
+
+
+void Game::StartRecording(const std::string& path) {
+    replay_writer_.Open(path, seed_, simulation_step_);
+    std::cout << "Recording replay to " << path << std::endl;
+}
+
+
+void Game::StopRecording(void) {
+    if (replay_writer_.IsOpen()) {
+        replay_writer_.Close(step_count_);
+    }
+}
+
+
+void Game::LoadReplay(const std::string& path) {
+    replay_reader_.Load(path);
+    SetSeed(replay_reader_.GetSeed());
+    SetSimulationRate(1.0 / replay_reader_.GetStep(), max_simulation_steps_);
+    std::cout << "Replaying " << path << ": seed " << replay_reader_.GetSeed() << ", ";
+    if (replay_reader_.GetStepCount() > 0) {
+        std::cout << replay_reader_.GetStepCount() << " steps" << std::endl;
+    }
+    else {
+        std::cout << "no end record" << std::endl;
+    }
+}
+
+
+void Game::Step(PlayerInput input) {
+    PROFILE_ZONE("Step");
+
+    previous_input_ = input_;
+    input_ = input;
+    replay_writer_.Record(step_count_, input_);
+
+    GameClock::Advance(simulation_step_);
+
+    // Handle user input
+    HandleControls(simulation_step_);
+
+    // Update all the game objects
+    Update(simulation_step_);
+
+    step_count_++;
+}
+
+
+void Game::RunHeadless(double duration) {
+    auto wall_start = std::chrono::steady_clock::now();
+    double start_time = GameClock::Now();
+    long steps = 0;
+
+    // A complete replay runs exactly as long as the recorded match
+    bool replaying = replay_reader_.IsLoaded();
+    uint32_t replay_steps = replaying ? replay_reader_.GetStepCount() : 0;
+
+    while (replay_steps > 0 ? step_count_ < replay_steps : GameClock::Now() - start_time < duration) {
+        if (IsMatchOver()) {
+            break;
+        }
+
+        Profiler::BeginFrame();
+        Step(replaying ? replay_reader_.InputAt(step_count_) : 0);
+        Profiler::EndFrame();
+        steps++;
+    }
+    StopRecording();
+
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    double simulated = GameClock::Now() - start_time;
+    std::cout << "Headless run: " << simulated << " s simulated in " << steps << " steps, "
+        << wall_seconds << " s wall time";
+    if (wall_seconds > 0.0) {
+        std::cout << " (" << simulated / wall_seconds << "x real time)";
+    }
+    std::cout << std::endl;
+    std::cout << "Final state: step " << step_count_ << ", digest " << std::hex << GetStateDigest() << std::dec << std::endl;
+    Profiler::PrintTable(std::cout);
+}
+
+
+void Game::PrintPoolStats(std::ostream& out) const {
+    entities_.PrintStats(out);
+    if (flame_emitter_.IsInitialized()) {
+        out << "  flame particles: " << flame_emitter_.GetHighWater() << " peak, capacity "
+            << flame_emitter_.GetCapacity() << ", " << flame_emitter_.GetOverflowCount() << " overwritten" << std::endl;
+    }
+}
+
+
 Game::~Game() {
     // Stop all audio before destroying game objects
     audio_system_.StopAll();
 
+    // Report how close the pools came to their capacity
+    if (headless_) {
+        PrintPoolStats(std::cout);
+    }
+
     // Free memory used by game world
     DestroyGameWorld();
 
+    JobSystem::Shutdown();
+
     // Cleanup textures
     if (tex_) {
-        glDeleteTextures(num_textures, tex_);
+        if (!headless_) {
+            // Names are shared between duplicate files, the loader deletes each once
+            texture_loader_.Release();
+            sprite_array_.Release();
+        }
         delete[] tex_;
         tex_ = nullptr;
     }
@@ -1846,8 +2488,11 @@ Game::~Game() {
     sprite_ = nullptr;
 
     // Close window
-    glfwDestroyWindow(window_);
-    glfwTerminate();
+    if (window_) {
+        RenderStats::Shutdown();
+        glfwDestroyWindow(window_);
+        glfwTerminate();
+    }
 
     delete minimap_sprite_;
     minimap_sprite_ = nullptr;
@@ -1861,37 +2506,4 @@ void Game::ResizeCallback(GLFWwindow* window, int width, int height)
     glViewport(0, 0, width, height);
 }
 
-void Game::SetTexture(GLuint w, const char* fname)
-{
-    // Bind texture buffer
-    glBindTexture(GL_TEXTURE_2D, w);
-
-    // Load texture from a file to the buffer
-    int width, height;
-    unsigned char* image = SOIL_load_image(fname, &width, &height, 0, SOIL_LOAD_RGBA);
-    if (!image) {
-        std::cout << "Cannot load texture " << fname << std::endl;
-    }
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    SOIL_free_image_data(image);
-
-    // Check if this is the stars/background texture and enable tiling
-    std::string filename(fname);
-    if (filename.find("stars.png") != std::string::npos || filename.find("stage_2.png") != std::string::npos) {
-        // Enable texture tiling/wrapping for the background
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    }
-    else {
-        // Default texture wrapping for other textures
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    }
-
-    // Texture Filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-}
-
-
-} // namespace game
\ No newline at end of file
+} // namespace game
\ No newline at end of file
@@ -25,16 +25,20 @@
 #include "boss_game_object.h"
 #include "space_dust.h"  // Add space dust header
 // #include "missile_game_object.h"
-#include "missile_flame.h"
+#include "flame_emitter.h"
 #include "mini_map.h"
 #include "minimap_sprite.h" 
+#include "entity_registry.h"
+#include "spatial_grid.h"
+#include "sprite_batch.h"
+#include "game_clock.h"
+#include "player_input.h"
+#include "replay_log.h"
+#include "texture_loader.h"
 
 
 namespace game {
 
-    // Forward declarations
-    class MissileFlame;
-
     // A class for holding the main game objects
     class Game {
 
@@ -43,9 +47,14 @@ namespace game {
         Game(void);
         ~Game();
 
-        // Call Init() before calling any other method
+        // Call Init() or InitHeadless() before calling any other method
         // Initialize graphics libraries and main window
-        void Init(void);
+        // A hidden window renders offscreen, without audio, for benchmarks
+        void Init(bool visible = true);
+
+        // Initialize for simulation only: no window, GL context or audio device,
+        // and timers run on a virtual clock
+        void InitHeadless(void);
 
         // Set up the game world (scene, game objects, etc.)
         void SetupGameWorld(void);
@@ -56,11 +65,83 @@ namespace game {
         // Run the game (keep the game active)
         void MainLoop(void);
 
+        // Run the simulation without rendering or input, as fast as possible,
+        // until the game ends or the given simulated time has passed
+        void RunHeadless(double duration);
+
+        // Set the fixed simulation rate, and how many steps a frame may run
+        // to catch up before the simulation slows down instead
+        void SetSimulationRate(double steps_per_second, int max_steps_per_frame);
+
+        // Seed of the match, call before Init() or InitHeadless()
+        // Without one the seed is taken from the time of day
+        void SetSeed(uint32_t seed);
+
+        // Save the seed and every step's input to a replay file
+        // Call after Init() or InitHeadless()
+        void StartRecording(const std::string& path);
+
+        // Write the end of the replay being recorded, if any
+        // MainLoop() and RunHeadless() do this when they return
+        void StopRecording(void);
+
+        // Re-simulate a recorded match, call before InitHeadless()
+        // The seed and simulation rate are taken from the file, and
+        // RunHeadless() feeds the recorded input and stops where it ends
+        void LoadReplay(const std::string& path);
+
+        // Entity counts a stress test keeps alive
+        struct StressLoad {
+            int enemies = 0;
+            int projectiles = 0;
+            int asteroids = 0;
+            int homing_missiles = 0;
+        };
+
+        // Benchmark setup, call before SetupGameWorld()
+        // Enemies of each type allowed at once (2 in a normal game)
+        void SetEnemyLimit(int max_per_type) { max_enemies_per_type_ = max_per_type; }
+        // Particles in the space dust field
+        void SetDustParticleCount(int count) { dust_particle_count_ = count; }
+        // The player ignores damage, so the match never ends by its death
+        void SetPlayerImmortal(bool immortal) { player_immortal_ = immortal; }
+
+        // Threads used for the enemy update, call before Init() or
+        // InitHeadless(); 0 (the default) uses every hardware thread
+        void SetThreadCount(int count) { thread_count_ = count; }
+
+        // Block until every texture is on the GPU, textures otherwise
+        // stream in over the first frames
+        void WaitForTextures(void);
+
+        // Run one benchmark frame: top the world up to the load, run one
+        // simulation step and, with a window, render and wait for the GPU
+        void RunBenchFrame(const StressLoad& load);
+
+        // Run one simulation step with scripted input and, with a window,
+        // render it; the input is recorded like the keyboard's would be
+        void RunScriptedFrame(PlayerInput input);
+
+        // Hash of the simulated world: the step, the level and every
+        // entity's kind and transform; visual-only effects are left out, so
+        // a match and its headless replay end on the same digest
+        uint64_t GetStateDigest(void) const;
+
+        // Peak use of the entity pools, and of the flame particle ring when
+        // there is one; headless runs print it when the game is destroyed
+        void PrintPoolStats(std::ostream& out) const;
+
+        inline bool IsGameOver(void) const { return game_over_; }
+
+        // True once the game over screen has run out and the match ends
+        inline bool IsMatchOver(void) const { return game_over_ && game_over_timer_.Finished(); }
+        inline const EntityRegistry& GetEntities(void) const { return entities_; }
+
         // Enemy count tracking
         int regular_enemy_count_;
         int fast_enemy_count_;
         int heavy_enemy_count_;
-        const int MAX_ENEMIES_PER_TYPE = 2;
+        int max_enemies_per_type_;
 
         inline int GetCurrentLevel() const { return current_level_; }
 
@@ -86,7 +167,8 @@ namespace game {
         int enemy_kills_;
         const int ENEMITES_TO_NEXT_LEVEL = 10;
         GLuint boss_level_background_texture_;
-        BossGameObject* boss_;
+        EntityHandle boss_;
+        BossGameObject* GetBoss() const;
         void CheckLevelProgression();
         void ClearGameObjects(bool keep_player_and_background = true);
         void SpawnBoss();
@@ -95,6 +177,12 @@ namespace game {
         // Main window: pointer to the GLFW window structure
         GLFWwindow* window_;
 
+        // Simulating without window, GL context or audio
+        bool headless_;
+
+        // Set up the state shared by the windowed and headless modes
+        void InitSimulation(void);
+
         // Sprite geometry
         Geometry* sprite_;
         void SpawnAsteroid(int count);
@@ -104,27 +192,111 @@ namespace game {
         // Shader for rendering sprites in the scene
         Shader sprite_shader_;
 
-        // timer for spawning enemies
-        Timer enemy_spawn_timer_;
+        // Instanced drawing of plain sprites, one draw per texture
+        Shader sprite_batch_shader_;
+        SpriteBatch sprite_batch_;
+
+        // Pending enemy spawn on the game clock
+        TimerWheel::TimerId enemy_spawn_event_;
+        void ScheduleEnemySpawn(double delay);
 
         // References to textures
         // This needs to be a pointer
         GLuint* tex_;
 
-        // List of game objects
-        std::vector<GameObject*> game_objects_;
+        // All game objects, pooled by kind
+        EntityRegistry entities_;
+
+        // Background is kept outside the registry so it always renders first
+        GameObject* background_;
+
+        // The player entity
+        EntityHandle player_;
+
+        // Collision broadphase, rebuilt once per tick
+        SpatialGrid collision_grid_;
+        void BuildCollisionGrid(void);
 
         Shader particle_shader_;  // Shader for particle systems
+        FlameEmitter flame_emitter_;  // Exhaust flames of every missile
         Shader dust_shader_;      // Shader for space dust particles
         SpaceDust* space_dust_;   // Space dust particle system
 
         void CreateHomingMissile(const glm::vec3& position, const glm::vec3& direction);
-        GameObject* FindClosestEnemy(const glm::vec3& position, float max_distance = 15.0f);
+        // Best enemy for a missile to chase, from the collision broadphase
+        EntityHandle FindMissileTarget(const HomingMissile* missile) const;
+        // Give every missile that is due a new target
+        void RetargetMissiles(void);
 
         // Keep track of time
         double current_time_;
 
-        // Handle user input
+        // Fixed simulation step in seconds, and the catch-up limit per frame
+        double simulation_step_;
+        int max_simulation_steps_;
+
+        // Save every object's transform before a simulation step
+        void SaveTransforms(void);
+
+        // Pause, fast-forward, profile and exit keys, read every frame even while paused
+        void HandleFrameControls(void);
+
+        // Print the profile table periodically, toggled with F3
+        bool show_profile_;
+
+        // GPU time and draw counts in the title bar and console, toggled with F4
+        bool show_render_stats_;
+        void ShowRenderStats(void);
+
+        // Match seed, input of the current and previous step, and steps run
+        uint32_t seed_;
+        PlayerInput input_;
+        PlayerInput previous_input_;
+        uint32_t step_count_;
+
+        // Replay being written, and replay being played back
+        ReplayWriter replay_writer_;
+        ReplayReader replay_reader_;
+
+        // Read the player's buttons from the keyboard
+        PlayerInput SampleInput(void) const;
+
+        // Run one simulation step with the given player input
+        void Step(PlayerInput input);
+
+
+        // Benchmark settings, see the public setters
+        int dust_particle_count_;
+        bool player_immortal_;
+
+        // Spawn whatever is missing from a stress load, at random positions
+        void MaintainStressLoad(const StressLoad& load);
+
+        // A shot decided by an enemy during the parallel think phase
+        struct EnemyFireCommand {
+            size_t enemy;           // Dense index of the enemy, orders the shots
+            glm::vec3 position;     // Muzzle position
+            float rotation;         // Enemy heading
+            int enemy_type;
+        };
+
+        // Threads the job system is started with
+        int thread_count_;
+
+        // Fire commands of the current step, one queue per job thread
+        std::vector<std::vector<EnemyFireCommand>> fire_queues_;
+        std::vector<EnemyFireCommand> fire_commands_;
+
+        // Update one enemy's state and target from the player's position,
+        // queueing a shot if it attacks; runs on job threads and only
+        // touches the enemy itself
+        void ThinkEnemy(EnemyGameObject* enemy, size_t index, const PlayerGameObject* player,
+            std::vector<EnemyFireCommand>& fire_queue) const;
+
+        // Think for every enemy in parallel, then fire their shots in enemy order
+        void UpdateEnemyAI(PlayerGameObject* player);
+
+        // Apply the current step's input to the player
         void HandleControls(double delta_time);
 
         // Update all the game objects
@@ -154,9 +326,16 @@ namespace game {
         // Process collisions between projectiles and enemies using ray-circle collision
         void ProcessProjectileEnemyCollisions(Projectile* projectile, EnemyGameObject* enemy, double delta_time);
 
+        // Process all collisions of one projectile (enemies, boss or player)
+        void ProcessProjectileCollisions(Projectile* projectile, PlayerGameObject* player, double delta_time);
+
+        // Process collisions between the player and collectibles or enemies
+        void ProcessPlayerCollisions(PlayerGameObject* player);
+        void ProcessPlayerCollectibleCollision(PlayerGameObject* player, CollectibleGameObject* collectible);
+        void ProcessPlayerEnemyCollision(PlayerGameObject* player, EnemyGameObject* enemy);
+
         // Audio system
         AudioSystem audio_system_;      // Audio system
-        ALuint background_music_;       // Background music
         ALuint explosion_sound_;        // Explosion sound
         ALuint pickup_sound_;           // Pickup orb sound
         ALuint invincible_start_sound_; // Invincible start sound
@@ -166,17 +345,18 @@ namespace game {
         ALuint hit_sound_;        // Sound for player being hit
 
 
-        // Render the game world
-        void Render(void);
+        // Render the game world, alpha is how far the frame is into the next step
+        void Render(float alpha);
 
         // Callback for when the window is resized
         static void ResizeCallback(GLFWwindow* window, int width, int height);
 
-        // Set a specific texture
-        void SetTexture(GLuint w, const char* fname);
-
-        // Load all textures
+        // Start loading all textures, see TextureLoader
         void LoadTextures(std::vector<std::string>& textures);
+        TextureLoader texture_loader_;
+
+        // Layers of every batched sprite's image, see SpriteBatch
+        SpriteArray sprite_array_;
 
         // Spawn collectibles
 
@@ -229,9 +409,10 @@ namespace game {
             tex_lower_part = 21,
             tex_upper_part = 22,
             tex_dust_particle = 23,     // Texture for space dust particles
+            tex_flame_particle = 24,    // Texture for missile flame particles
             TEXTURE_COUNT
         };
     }; // class Game
 
 } // namespace game
-#endif // GAME_H
\ No newline at end of file
+#endif // GAME_H
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "game_clock.h"
+
+namespace game {
+
+    double GameClock::now_ = 0.0;
+    bool GameClock::paused_ = false;
+    double GameClock::time_scale_ = 1.0;
+    TimerWheel GameClock::timers_;
+
+    void GameClock::Reset(double start_time) {
+        timers_.Clear();
+        now_ = start_time;
+        timers_.Advance(now_);
+    }
+
+    void GameClock::Advance(double seconds) {
+        now_ += seconds;
+        timers_.Advance(now_);
+    }
+
+    double GameClock::Scale(double real_seconds) {
+        return paused_ ? 0.0 : real_seconds * time_scale_;
+    }
+
+    TimerWheel::TimerId GameClock::Schedule(double delay, std::function<void()> callback) {
+        return timers_.Schedule(now_, delay, std::move(callback));
+    }
+
+    bool GameClock::Cancel(TimerWheel::TimerId id) {
+        return timers_.Cancel(id);
+    }
+
+} // namespace game
@@ -0,0 +1,50 @@
+#ifndef GAME_CLOCK_H_
+#define GAME_CLOCK_H_
+
+#include <functional>
+
+#include "timer_wheel.h"
+
+namespace game {
+
+    // Game time, shared by every timer
+    // The clock only moves when the game loop advances it by a simulation
+    // step, so reading it is free and every query within a step agrees.
+    // The loop asks Scale() how much game time a stretch of real time is
+    // worth, which is how pause, slow motion and fast-forward work. Headless
+    // runs advance it as fast as the CPU allows
+    class GameClock {
+    public:
+        // Current game time in seconds
+        static inline double Now(void) { return now_; }
+
+        // Restart at the given time, dropping scheduled callbacks
+        static void Reset(double start_time = 0.0);
+
+        // Move game time forward and run the callbacks that fall due
+        static void Advance(double seconds);
+
+        // Game time that passes during the given real time
+        static double Scale(double real_seconds);
+
+        // Pause stops game time, the time scale speeds it up or slows it down
+        static void SetPaused(bool paused) { paused_ = paused; }
+        static bool IsPaused(void) { return paused_; }
+        static void SetTimeScale(double scale) { time_scale_ = scale; }
+        static double GetTimeScale(void) { return time_scale_; }
+
+        // Run a callback once delay seconds of game time from now
+        static TimerWheel::TimerId Schedule(double delay, std::function<void()> callback);
+        static bool Cancel(TimerWheel::TimerId id);
+
+    private:
+        static double now_;
+        static bool paused_;
+        static double time_scale_;
+        static TimerWheel timers_;
+
+    }; // class GameClock
+
+} // namespace game
+
+#endif // GAME_CLOCK_H_
@@ -6,11 +6,13 @@
 #include "shader.h"
 
 #include "game_object.h"
-#include "player_game_object.h"
+#include "render_stats.h"
+#include "sprite_batch.h"
 
 namespace game {
 
     GameObject::GameObject(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture)
+        : render_state_(RenderState::Opaque())
     {
         if (!geom || !shader) {
             throw std::runtime_error("Invalid geometry or shader in GameObject constructor");
@@ -20,14 +22,22 @@ namespace game {
         position_ = position;
         scale_ = glm::vec2(1.0f, 1.0f);  // Default uniform scaling
         angle_ = 0.0;
+        previous_position_ = position;
+        previous_angle_ = 0.0f;
+        render_position_ = position;
+        render_angle_ = 0.0f;
         geometry_ = geom;
         shader_ = shader;
+        view_matrix_id_ = shader->GetUniformId("view_matrix");
+        transformation_matrix_id_ = shader->GetUniformId("transformation_matrix");
+        ghost_mode_id_ = shader->GetUniformId("ghost_mode");
         texture_ = texture;
         original_texture_ = texture;
         explosion_texture_ = texture;
         is_active_ = true;
         is_exploding_ = false;
         is_ghost_ = false;  // Default: not in ghost mode
+        kind_ = EntityKind::KIND_COUNT;
     }
 
 
@@ -56,12 +66,41 @@ namespace game {
     }
 
 
+    void GameObject::SaveTransform(void) {
+        previous_position_ = position_;
+        previous_angle_ = angle_;
+    }
+
+
+    void GameObject::SnapTransform(void) {
+        SaveTransform();
+        render_position_ = position_;
+        render_angle_ = angle_;
+    }
+
+
+    void GameObject::InterpolateTransform(float alpha) {
+        render_position_ = previous_position_ + (position_ - previous_position_) * alpha;
+
+        // Turn the short way round, angles wrap at 2*pi
+        float pi = glm::pi<float>();
+        float turn = angle_ - previous_angle_;
+        if (turn > pi) {
+            turn -= 2.0f * pi;
+        }
+        else if (turn < -pi) {
+            turn += 2.0f * pi;
+        }
+        render_angle_ = previous_angle_ + turn * alpha;
+    }
+
+
     void GameObject::Update(double delta_time) {
         if (is_exploding_ && explosion_timer_.Finished()) {
             is_active_ = false;
             // Don't reset the texture for player explosion
             // Only reset for regular game objects (enemies)
-            if (dynamic_cast<PlayerGameObject*>(this) == nullptr) {
+            if (kind_ != EntityKind::PLAYER) {
                 texture_ = original_texture_;
             }
         }
@@ -79,34 +118,42 @@ namespace game {
         shader_->Enable();
 
         // Set up the view matrix
-        shader_->SetUniformMat4("view_matrix", view_matrix);
+        shader_->SetUniformMat4(view_matrix_id_, view_matrix);
 
         // Setup the scaling matrix for the shader using the 2D scale vector
         glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_.x, scale_.y, 1.0f));
 
         // Setup the rotation matrix for the shader
-        glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), angle_, glm::vec3(0.0, 0.0, 1.0));
+        glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), render_angle_, glm::vec3(0.0, 0.0, 1.0));
 
         // Set up the translation matrix for the shader
-        glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
+        glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), render_position_);
 
         // Setup the transformation matrix for the shader
         glm::mat4 transformation_matrix = translation_matrix * rotation_matrix * scaling_matrix;
 
         // Set the transformation matrix in the shader
-        shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
+        shader_->SetUniformMat4(transformation_matrix_id_, transformation_matrix);
 
         // Set ghost mode uniform in shader (convert bool to int for GLSL)
-        shader_->SetUniform1i("ghost_mode", is_ghost_ ? 1 : 0);
+        shader_->SetUniform1i(ghost_mode_id_, is_ghost_ ? 1 : 0);
 
-        // Set up the geometry
+        // Set up the geometry and fixed-function state
         geometry_->SetGeometry(shader_->GetShaderProgram());
+        render_state_.Apply();
 
         // Bind the entity's texture
         glBindTexture(GL_TEXTURE_2D, texture_);
+        RenderStats::CountTextureBind();
 
         // Draw the entity
         glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+        RenderStats::CountDraw();
+    }
+
+
+    bool GameObject::Submit(SpriteBatch& batch) {
+        return batch.Add(render_state_, texture_, render_position_, scale_, render_angle_, is_ghost_);
     }
 
 } // namespace game
\ No newline at end of file
@@ -8,9 +8,13 @@
 #include "shader.h"
 #include "geometry.h"
 #include "timer.h"
+#include "render_state.h"
+#include "entity_handle.h"
 
 namespace game {
 
+    class SpriteBatch;
+
     /*
         GameObject is responsible for handling the rendering and updating of one object in the game world
         The update and render methods are virtual, so you can inherit them from GameObject and override the update or render functionality (see PlayerGameObject for reference)
@@ -21,17 +25,40 @@ namespace game {
         // Constructor
         GameObject(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture);
 
+        // Objects are deleted through base pointers by the entity pools
+        virtual ~GameObject() {}
+
         // Update the GameObject's state. Can be overriden in children
         virtual void Update(double delta_time);
 
         // Renders the GameObject 
         virtual void Render(glm::mat4 view_matrix, double current_time);
 
+        // Queue the GameObject into a sprite batch instead of rendering it directly
+        // Returns false if the object has to be drawn with Render(). Children that
+        // override Render must override this too
+        virtual bool Submit(SpriteBatch& batch);
+
         // Getters
         inline glm::vec3 GetPosition(void) const { return position_; }
         inline glm::vec2 GetScale(void) const { return scale_; }
         inline float GetRotation(void) const { return angle_; }
 
+        // Remember the transform at the start of a simulation step
+        virtual void SaveTransform(void);
+
+        // Draw the current transform as is from now on, without blending
+        // from the saved one; for spawns and teleports
+        void SnapTransform(void);
+
+        // Blend the drawn transform between the saved and the current one,
+        // alpha is how far the display time is into the next step
+        virtual void InterpolateTransform(float alpha);
+
+        // Transform used for drawing, set by InterpolateTransform
+        inline glm::vec3 GetRenderPosition(void) const { return render_position_; }
+        inline float GetRenderRotation(void) const { return render_angle_; }
+
         virtual void PrepareForDestruction() {
             // Mark object as inactive, but don't delete anything here
             is_active_ = false;
@@ -59,6 +86,10 @@ namespace game {
 
         inline void SetTexture(GLuint texture) {texture_ = texture;}
 
+        // Depth and blend state used to draw the object
+        inline void SetRenderState(const RenderState& state) { render_state_ = state; }
+        inline const RenderState& GetRenderState(void) const { return render_state_; }
+
 
         // Set ghost mode
         inline void SetGhost(bool ghost) { is_ghost_ = ghost; }
@@ -74,6 +105,11 @@ namespace game {
         void SetExplosionTexture(GLuint explosion_tex) { explosion_texture_ = explosion_tex; }
         void StartExplosion();
 
+        // Kind of pool the object lives in, stamped by the pool on Add()
+        // Objects kept outside the registry report KIND_COUNT
+        inline EntityKind GetKind(void) const { return kind_; }
+        inline void SetKind(EntityKind kind) { kind_ = kind; }
+
 
 
     protected:
@@ -82,11 +118,20 @@ namespace game {
         glm::vec2 scale_;  // 2D scale (x, y) for non-uniform scaling
         float angle_;
 
+        // Transform at the start of the current step, and the blend drawn
+        glm::vec3 previous_position_;
+        float previous_angle_;
+        glm::vec3 render_position_;
+        float render_angle_;
+
         // Geometry
         Geometry* geometry_;
 
-        // Shader
+        // Shader, and the uniforms Render() sets on it
         Shader* shader_;
+        UniformId view_matrix_id_;
+        UniformId transformation_matrix_id_;
+        UniformId ghost_mode_id_;
 
         // Object's texture references
         GLuint texture_;
@@ -99,8 +144,14 @@ namespace game {
         bool is_ghost_;    // Ghost mode for grayscale rendering
         Timer explosion_timer_;
 
+        // Type tag, checked instead of casting
+        EntityKind kind_;
+
+        // Depth and blend state, opaque by default
+        RenderState render_state_;
+
     }; // class GameObject
 
 } // namespace game
 
-#endif // GAME_OBJECT_H_
\ No newline at end of file
+#endif // GAME_OBJECT_H_
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "game_timer.h"
+#include "render_stats.h"
+#include "game_clock.h"
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -6,7 +8,7 @@ namespace game {
     // Constructor
     GameTimer::GameTimer(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture)
         : TextGameObject(position, geom, shader, texture) {
-        start_time_ = glfwGetTime();
+        start_time_ = GameClock::Now();
         last_update_seconds_ = -1;
         last_time_string_ = "Time: 00:00";
         SetText(last_time_string_);
@@ -30,10 +32,6 @@ namespace game {
     }
 
     void GameTimer::RenderUI(glm::mat4 ui_projection_matrix, double current_time) {
-        // Enable blending
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
         // Safety checks
         if (!geometry_ || !shader_) {
             std::cerr << "Error: Geometry or shader not initialized" << std::endl;
@@ -46,7 +44,7 @@ namespace game {
         }
 
         shader_->Enable();
-        shader_->SetUniformMat4("view_matrix", ui_projection_matrix);
+        shader_->SetUniformMat4(view_matrix_id_, ui_projection_matrix);
 
         // Setup scaling and translation
         glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f),
@@ -54,11 +52,13 @@ namespace game {
         glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
         glm::mat4 transformation_matrix = translation_matrix * scaling_matrix;
 
-        shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-        shader_->SetUniform1i("ghost_mode", 0);
+        shader_->SetUniformMat4(transformation_matrix_id_, transformation_matrix);
+        shader_->SetUniform1i(ghost_mode_id_, 0);
 
         geometry_->SetGeometry(shader_->GetShaderProgram());
+        RenderState::Overlay().Apply();
         glBindTexture(GL_TEXTURE_2D, texture_);
+        RenderStats::CountTextureBind();
 
         // Prepare text rendering
 #define TEXT_LENGTH 40
@@ -66,23 +66,23 @@ namespace game {
         if (final_size > TEXT_LENGTH) {
             final_size = TEXT_LENGTH;
         }
-        shader_->SetUniform1i("text_len", final_size);
+        shader_->SetUniform1i(text_len_id_, final_size);
 
         GLint text_data[TEXT_LENGTH];
         for (int i = 0; i < final_size; i++) {
             text_data[i] = text[i];
         }
-        shader_->SetUniformIntArray("text_content", final_size, text_data);
+        shader_->SetUniformIntArray(text_content_id_, final_size, text_data);
 
         // Draw text
         glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+        RenderStats::CountDraw();
 
         shader_->Disable();
-        glDisable(GL_BLEND);
     }
 
     void GameTimer::Update(double delta_time) {
-        double current_time = glfwGetTime(); // Get the current time
+        double current_time = GameClock::Now(); // Get the current time
         // Calculate the duration
         double duration = current_time - start_time_;
         int current_seconds = static_cast<int>(duration);
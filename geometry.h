@@ -6,26 +6,53 @@
 
 namespace game {
 
+    // Fixed vertex attribute locations shared by every shader and geometry
+    // Shader::Init binds the attribute names to these before linking, so a
+    // vertex array object built once works with any shader
+    enum VertexAttribute {
+        ATTRIB_VERTEX = 0,            // "vertex"
+        ATTRIB_COLOR = 1,             // "color"
+        ATTRIB_UV = 2,                // "uv"
+        ATTRIB_INSTANCE_0 = 3,        // "instance_position_angle" (SpriteBatch), "dust_motion" (SpaceDust), "flame_transform" (FlameEmitter)
+        ATTRIB_INSTANCE_1 = 4,        // "instance_scale_ghost" (SpriteBatch), "dust_look" (SpaceDust), "flame_alpha" (FlameEmitter)
+        ATTRIB_INSTANCE_2 = 5         // "instance_uv_layer" (SpriteBatch)
+    };
+
     // A piece of geometry
     class Geometry {
 
         public:
             // Constructor and destructor
-            Geometry(void) {};
+            Geometry(void) : vbo_(0), ebo_(0), vao_(0), size_(0) {};
+            virtual ~Geometry() {};
 
             // Create the geometry (called once)
             virtual void CreateGeometry(void) {};
 
-            // Use the geometry
-            virtual void SetGeometry(GLuint shader_program) {};
+            // Use the geometry: binds its vertex array object
+            // The shader argument is unused since attribute locations are fixed
+            virtual void SetGeometry(GLuint shader_program) { glBindVertexArray(vao_); };
+
+            // Bind the buffers and describe their attributes into the
+            // currently bound vertex array object
+            virtual void SetupAttributes(void) {};
 
             // Getter
             int GetSize(void) const { return size_; }
 
         protected:
+            // Create the vertex array object from SetupAttributes (call from CreateGeometry)
+            void CreateVertexArray(void) {
+                glGenVertexArrays(1, &vao_);
+                glBindVertexArray(vao_);
+                SetupAttributes();
+                glBindVertexArray(0);
+            }
+
             // Geometry buffers
             GLuint vbo_;
             GLuint ebo_;
+            GLuint vao_;
             int size_;
 
     }; // class Geometry
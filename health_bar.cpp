@@ -1,4 +1,6 @@
 #include "health_bar.h"
+#include "render_stats.h"
+#include "render_state.h"
 
 namespace game {
     // Constructor
@@ -12,13 +14,16 @@ namespace game {
     void HealthBar::Init(Geometry* geometry, Shader* shader, GLuint background, GLuint fill) {
         geometry_ = geometry;
         shader_ = shader;
+        view_matrix_id_ = shader->GetUniformId("view_matrix");
+        transformation_matrix_id_ = shader->GetUniformId("transformation_matrix");
+        ghost_mode_id_ = shader->GetUniformId("ghost_mode");
         background_ = background;
         fill_ = fill;
     }
 
     void HealthBar::Render(const glm::mat4& view_matrix, float health) {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        RenderPassScope pass(RenderPass::HEALTH_BAR);
+
         // Validate input and initialization
         if (!geometry_ || !shader_) {
             std::cerr << "ERROR: Health bar missing geometry or shader" << std::endl;
@@ -31,13 +36,13 @@ namespace game {
             return;
         }
 
-        // Reset OpenGL state
-        // glDisable(GL_DEPTH_TEST);
+        // Screen-space UI, drawn over the scene
+        RenderState::Overlay().Apply();
         health = glm::clamp(health, 0.0f, 1.0f);
 
         // Ensure shader is ready
         shader_->Enable();
-        shader_->SetUniformMat4("view_matrix", view_matrix);
+        shader_->SetUniformMat4(view_matrix_id_, view_matrix);
 
         // USE SIMPLER APPROACH: Just draw two rectangles
 
@@ -51,12 +56,14 @@ namespace game {
             glm::mat4 transformation_matrix = translation_matrix * scaling_matrix;
             
             //send transoformation matrix to shader
-            shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-            shader_->SetUniform1i("ghost_mode", 0); //don't need ghost mode
+            shader_->SetUniformMat4(transformation_matrix_id_, transformation_matrix);
+            shader_->SetUniform1i(ghost_mode_id_, 0); //don't need ghost mode
             geometry_->SetGeometry(shader_->GetShaderProgram());
             //draw backgound
             glBindTexture(GL_TEXTURE_2D, background_);
+            RenderStats::CountTextureBind();
             glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+            RenderStats::CountDraw();
         }
 
         // 2. Draw health fill (colored bar) - simplified positioning
@@ -68,15 +75,16 @@ namespace game {
             glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), fill_position);
             glm::mat4 transformation_matrix = translation_matrix * scaling_matrix;
             //send transoformation matrix to shader
-            shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-            shader_->SetUniform1i("ghost_mode", 0); //don't need ghost mode
+            shader_->SetUniformMat4(transformation_matrix_id_, transformation_matrix);
+            shader_->SetUniform1i(ghost_mode_id_, 0); //don't need ghost mode
             geometry_->SetGeometry(shader_->GetShaderProgram());
             glBindTexture(GL_TEXTURE_2D, fill_);
+            RenderStats::CountTextureBind();
             glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+            RenderStats::CountDraw();
         }
 
         // Clean up
         shader_->Disable();
-        glEnable(GL_DEPTH_TEST);
     }
 }
\ No newline at end of file
@@ -34,6 +34,9 @@ namespace game {
 
         Geometry* geometry_; // Geometry to render the bar
         Shader* shader_;     // Shader to use
+        UniformId view_matrix_id_;
+        UniformId transformation_matrix_id_;
+        UniformId ghost_mode_id_;
 
         glm::vec3 position_; // Position on screen
         float width_;        // Width of the bar
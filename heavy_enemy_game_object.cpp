@@ -1,5 +1,6 @@
 // heavy_enemy_game_object.cpp
 #include "heavy_enemy_game_object.h"
+#include "random.h"
 #include <iostream>
 #include <glm/gtc/constants.hpp>
 
@@ -147,7 +148,7 @@ namespace game {
 
                 // Charge to a point near the player
                 float angle = atan2(direction.y, direction.x);
-                float offset_angle = angle + ((rand() % 100) / 100.0f - 0.5f) * 1.5f;
+                float offset_angle = angle + (rng_.Index(100) / 100.0f - 0.5f) * 1.5f;
                 float offset_distance = distance_to_target * 0.7f;
 
                 charge_target_ = position +
@@ -155,8 +156,6 @@ namespace game {
 
                 ResetAttackCooldown(2.0f);
                 charge_cooldown_.Start(5.0f);
-
-                std::cout << "Heavy enemy charging attack!" << std::endl;
                 return;
             }
         }
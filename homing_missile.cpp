@@ -1,7 +1,9 @@
 // homing_missile.cpp
 #include "homing_missile.h"
 #include "enemy_game_object.h"
+#include "entity_registry.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace game {
@@ -11,7 +13,7 @@ namespace game {
         : Projectile(position, geom, shader, texture, direction) {
 
         // Initialize homing missile properties
-        target_ = nullptr;
+        registry_ = nullptr;
         turning_speed_ = 3.0f;  // Radians per second - how fast it can turn
         damage_ = 0.7f;         // Lower damage than standard projectile
 
@@ -19,7 +21,29 @@ namespace game {
         SetScale(0.4f);
 
         // Initialize retarget timer - look for new target every 0.5 seconds
-        retarget_timer_.Start(0.5f);
+        retarget_timer_.Start(RETARGET_INTERVAL);
+    }
+
+    float HomingMissile::TargetCost(const glm::vec3& target_position) const {
+        glm::vec3 to_target = target_position - GetPosition();
+        float distance = glm::length(to_target);
+        if (distance > SEEK_RANGE) {
+            return -1.0f;
+        }
+        if (distance < 0.001f) {
+            return 0.0f;
+        }
+
+        // Angle between the flight direction and the target
+        glm::vec3 direction = GetDirection();
+        float cosine = glm::dot(direction, to_target) / (glm::length(direction) * distance);
+        float angle = std::acos(std::min(std::max(cosine, -1.0f), 1.0f));
+        if (angle > SEEK_HALF_ANGLE) {
+            return -1.0f;
+        }
+
+        // Distance covered while turning at full rate
+        return distance + GetSpeed() * angle / turning_speed_;
     }
 
     void HomingMissile::Update(double delta_time) {
@@ -32,8 +56,11 @@ namespace game {
         glm::vec3 position = GetPosition();
         glm::vec3 direction = GetDirection();
 
+        // Resolve the target; a stale handle means it was already removed
+        GameObject* target = registry_ ? registry_->Get(target_) : nullptr;
+
         // Simple straight-line movement if target is invalid
-        if (target_ == nullptr || !target_->IsActive() || target_->IsExploding()) {
+        if (target == nullptr || !target->IsActive() || target->IsExploding()) {
             position += direction * GetSpeed() * static_cast<float>(delta_time);
             SetPosition(position);
 
@@ -42,16 +69,17 @@ namespace game {
 
             GameObject::Update(delta_time);
 
-            // Check if we need to find a new target
-            if (retarget_timer_.Finished()) {
-                retarget_timer_.Start(0.5f);
+            // A lost target is replaced on the next retarget pass
+            if (target_.IsSet()) {
+                target_ = EntityHandle();
+                retarget_timer_.Start(0.0f);
             }
             return;
         }
 
         // Target is valid, so we can safely access it
         // Calculate vector to target
-        glm::vec3 to_target = target_->GetPosition() - position;
+        glm::vec3 to_target = target->GetPosition() - position;
         float distance_to_target = glm::length(to_target);
 
         // Only adjust direction if target is far enough
@@ -85,13 +113,8 @@ namespace game {
         position += direction * GetSpeed() * static_cast<float>(delta_time);
         SetPosition(position);
 
-        // Check if we need to find a new target
-        if (retarget_timer_.Finished()) {
-            retarget_timer_.Start(0.5f);
-        }
-
         // Parent update
         GameObject::Update(delta_time);
     }
 
-} // namespace game
\ No newline at end of file
+} // namespace game
\ No newline at end of file
@@ -3,12 +3,21 @@
 #define HOMING_MISSILE_H_
 
 #include "projectile_game_object.h"
+#include "entity_handle.h"
 #include "timer.h"
 
 namespace game {
 
+    class EntityRegistry;
+
     class HomingMissile : public Projectile {
     public:
+        // Targets are sought this far ahead, within this angle either side
+        // of the flight direction, every RETARGET_INTERVAL seconds
+        static constexpr float SEEK_RANGE = 15.0f;
+        static constexpr float SEEK_HALF_ANGLE = 1.5707964f;  // 90 degrees
+        static constexpr float RETARGET_INTERVAL = 0.5f;
+
         // Constructor
         HomingMissile(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture,
             const glm::vec3& direction);
@@ -16,14 +25,29 @@ namespace game {
         // Override update method to implement homing behavior
         void Update(double delta_time) override;
 
-        // Set the target to track
-        void SetTarget(GameObject* target) { target_ = target; }
+        // Set the target to track, resolved through the registry every update
+        // An unset handle flies straight on until the next retarget
+        void SetTarget(const EntityRegistry* registry, EntityHandle target) {
+            registry_ = registry;
+            target_ = target;
+            retarget_timer_.Start(RETARGET_INTERVAL);
+        }
+
+        // True when the missile should be given a new target, periodically
+        // and as soon as its target is gone
+        bool NeedsTarget(void) const { return retarget_timer_.Finished(); }
+
+        // How attractive a target at this position is: its distance plus the
+        // distance flown while turning towards it, so targets ahead win over
+        // nearer ones behind; negative if out of range or outside the cone
+        float TargetCost(const glm::vec3& target_position) const;
 
         // Get damage value (lower than regular projectile)
         float GetDamage() const { return damage_; }
 
     private:
-        GameObject* target_;           // The current tracking target
+        const EntityRegistry* registry_; // Registry used to resolve the target
+        EntityHandle target_;          // The current tracking target
         float turning_speed_;          // How fast the missile can turn
         float damage_;                 // Damage value (less than regular projectile)
         Timer retarget_timer_;         // Timer for finding new targets if current is invalid
@@ -31,4 +55,4 @@ namespace game {
 
 } // namespace game
 
-#endif // HOMING_MISSILE_H_
\ No newline at end of file
+#endif // HOMING_MISSILE_H_
\ No newline at end of file
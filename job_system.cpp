@@ -0,0 +1,180 @@
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "job_system.h"
+
+namespace game {
+
+    namespace {
+
+        // A run of loop elements handed to one thread
+        struct Chunk {
+            size_t begin;
+            size_t end;
+        };
+
+        // One queue per thread, the owner pops from the back and thieves
+        // take from the front
+        struct ChunkQueue {
+            std::mutex mutex;
+            std::deque<Chunk> chunks;
+        };
+
+        std::vector<std::thread> workers_g;
+        std::vector<std::unique_ptr<ChunkQueue>> queues_g;
+
+        // The loop being run and how many of its chunks are unfinished
+        const JobSystem::RangeJob* job_g = nullptr;
+        std::atomic<size_t> pending_g(0);
+
+        // Workers sleep until the generation changes or the pool stops
+        std::mutex wake_mutex_g;
+        std::condition_variable wake_g;
+        uint64_t generation_g = 0;
+        bool stopping_g = false;
+
+        // Index of this thread in the pool, -1 outside of a loop
+        thread_local int thread_index_g = -1;
+
+        // Run one chunk, from the own queue if possible, stealing otherwise
+        // Returns false once every queue is empty
+        bool RunOne(int self) {
+            int count = static_cast<int>(queues_g.size());
+            for (int k = 0; k < count; k++) {
+                ChunkQueue& queue = *queues_g[(self + k) % count];
+                Chunk chunk;
+                {
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (queue.chunks.empty()) {
+                        continue;
+                    }
+                    if (k == 0) {
+                        chunk = queue.chunks.back();
+                        queue.chunks.pop_back();
+                    }
+                    else {
+                        chunk = queue.chunks.front();
+                        queue.chunks.pop_front();
+                    }
+                }
+                (*job_g)(chunk.begin, chunk.end, self);
+                pending_g.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+            return false;
+        }
+
+        void WorkerMain(int index) {
+            thread_index_g = index;
+            uint64_t seen = 0;
+            while (true) {
+                while (RunOne(index)) {
+                }
+
+                std::unique_lock<std::mutex> lock(wake_mutex_g);
+                wake_g.wait(lock, [&seen] { return stopping_g || generation_g != seen; });
+                if (stopping_g) {
+                    return;
+                }
+                seen = generation_g;
+            }
+        }
+
+    } // namespace
+
+
+    void JobSystem::Init(int thread_count) {
+        Shutdown();
+
+        if (thread_count <= 0) {
+            thread_count = static_cast<int>(std::thread::hardware_concurrency());
+            if (thread_count <= 0) {
+                thread_count = 1;
+            }
+        }
+
+        for (int i = 0; i < thread_count; i++) {
+            queues_g.push_back(std::unique_ptr<ChunkQueue>(new ChunkQueue()));
+        }
+        stopping_g = false;
+        generation_g = 0;
+
+        // Thread 0 is whoever calls ParallelFor
+        for (int i = 1; i < thread_count; i++) {
+            workers_g.push_back(std::thread(WorkerMain, i));
+        }
+    }
+
+
+    void JobSystem::Shutdown(void) {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_g);
+            stopping_g = true;
+        }
+        wake_g.notify_all();
+        for (std::thread& worker : workers_g) {
+            worker.join();
+        }
+        workers_g.clear();
+        queues_g.clear();
+    }
+
+
+    int JobSystem::GetThreadCount(void) {
+        return queues_g.empty() ? 1 : static_cast<int>(queues_g.size());
+    }
+
+
+    void JobSystem::ParallelFor(size_t count, size_t grain, const RangeJob& job) {
+        if (count == 0) {
+            return;
+        }
+        if (grain == 0) {
+            grain = 1;
+        }
+
+        // Small loops, nested loops and a single thread run inline
+        int threads = static_cast<int>(queues_g.size());
+        if (threads <= 1 || thread_index_g >= 0 || count <= grain) {
+            job(0, count, thread_index_g >= 0 ? thread_index_g : 0);
+            return;
+        }
+
+        // Deal the chunks out round-robin
+        size_t chunk_count = (count + grain - 1) / grain;
+        job_g = &job;
+        pending_g.store(chunk_count, std::memory_order_release);
+        for (int t = 0; t < threads; t++) {
+            std::lock_guard<std::mutex> lock(queues_g[t]->mutex);
+            for (size_t c = t; c < chunk_count; c += threads) {
+                Chunk chunk;
+                chunk.begin = c * grain;
+                chunk.end = (c + 1) * grain < count ? (c + 1) * grain : count;
+                queues_g[t]->chunks.push_back(chunk);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_g);
+            generation_g++;
+        }
+        wake_g.notify_all();
+
+        // Help out, then wait for the chunks other threads took
+        thread_index_g = 0;
+        while (RunOne(0)) {
+        }
+        while (pending_g.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+        thread_index_g = -1;
+        job_g = nullptr;
+    }
+
+} // namespace game
@@ -0,0 +1,40 @@
+#ifndef JOB_SYSTEM_H_
+#define JOB_SYSTEM_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace game {
+
+    // A small pool of worker threads for data-parallel loops
+    // ParallelFor() cuts a range into chunks and deals them out to one queue
+    // per thread; a thread that runs out of chunks steals from the others, so
+    // uneven chunks still balance. The calling thread takes part and the call
+    // returns once every chunk is done
+    // Jobs must only touch the elements of their own chunk, and anything
+    // they produce for the rest of the game goes into a per-thread buffer
+    // (indexed by the thread argument) that the caller merges afterwards
+    class JobSystem {
+    public:
+        // Body of a loop: runs elements [begin, end) on the given thread,
+        // thread is in [0, GetThreadCount()) and 0 is the calling thread
+        typedef std::function<void(size_t begin, size_t end, int thread)> RangeJob;
+
+        // Start the workers, thread_count counts the calling thread too
+        // 0 uses every hardware thread, 1 runs every loop inline
+        // Restarts the pool if it is already running
+        static void Init(int thread_count = 0);
+        static void Shutdown(void);
+
+        // Threads taking part in a loop, including the caller
+        static int GetThreadCount(void);
+
+        // Run job over [0, count) in chunks of at most grain elements
+        // Called from inside a job, the loop runs inline on that thread
+        static void ParallelFor(size_t count, size_t grain, const RangeJob& job);
+
+    }; // class JobSystem
+
+} // namespace game
+
+#endif // JOB_SYSTEM_H_
@@ -16,19 +16,102 @@
 
 #include <iostream>
 #include <exception>
+#include <string>
+#include <cstdlib>
 #include "game.h"
+#include "profiler.h"
+#include "render_stats.h"
 
 // Macro for printing exceptions
 #define PrintException(exception_object)\
     std::cerr << exception_object.what() << std::endl
 
 // Main function that builds and runs the game
-int main(void){
+// Pass --headless [seconds] to simulate without window, graphics or audio
+// (default 600 simulated seconds)
+// --seed N fixes the match seed, --record file saves the match to a replay
+// and --replay file re-simulates a recorded match headless at full speed
+// --trace file writes the profiler's zones as a Chrome trace, and
+// --render-stats file writes GPU time and GL call counts per render pass as CSV
+// --threads N limits the threads updating enemies (default: every hardware thread)
+int main(int argc, char* argv[]){
+    bool headless = false;
+    double headless_duration = 600.0;
+    bool has_seed = false;
+    unsigned long seed = 0;
+    std::string record_path;
+    std::string replay_path;
+    std::string trace_path;
+    std::string render_stats_path;
+    int thread_count = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoul(argv[++i], nullptr, 10);
+            has_seed = true;
+        }
+        else if (arg == "--record" && i + 1 < argc) {
+            record_path = argv[++i];
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            trace_path = argv[++i];
+        }
+        else if (arg == "--render-stats" && i + 1 < argc) {
+            render_stats_path = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            thread_count = std::atoi(argv[++i]);
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            replay_path = argv[++i];
+            headless = true;
+        }
+        else if (arg == "--headless") {
+            headless = true;
+            if (i + 1 < argc) {
+                char* end;
+                double seconds = std::strtod(argv[i + 1], &end);
+                if (end != argv[i + 1] && *end == '\0') {
+                    headless_duration = seconds;
+                    i++;
+                }
+            }
+        }
+    }
+
     game::Game the_game;
 
     try {
+        the_game.SetThreadCount(thread_count);
+        if (has_seed) {
+            the_game.SetSeed(static_cast<uint32_t>(seed));
+        }
+        if (!replay_path.empty()) {
+            the_game.LoadReplay(replay_path);
+        }
+        if (!trace_path.empty()) {
+            game::Profiler::StartTrace(trace_path);
+        }
+
+        if (headless) {
+            the_game.InitHeadless();
+            if (!record_path.empty()) {
+                the_game.StartRecording(record_path);
+            }
+            the_game.SetupGameWorld();
+            the_game.RunHeadless(headless_duration);
+            game::Profiler::StopTrace();
+            return 0;
+        }
+
         // Initialize graphics libraries and main window
         the_game.Init();
+        if (!render_stats_path.empty()) {
+            game::RenderStats::StartCsv(render_stats_path);
+        }
+        if (!record_path.empty()) {
+            the_game.StartRecording(record_path);
+        }
         // Setup the game world (textures, game objects, etc.)
         the_game.SetupGameWorld();
         // Run the game
@@ -38,6 +121,7 @@ int main(void){
         // Catch and print any errors
         PrintException(e);
     }
+    game::Profiler::StopTrace();
 
     return 0;
 }
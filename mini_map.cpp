@@ -1,8 +1,12 @@
 #include "mini_map.h"
+#include "render_stats.h"
 #include "game_object.h"
 #include "player_game_object.h"
 #include "enemy_game_object.h"
 #include "boss_game_object.h"
+#include "entity_registry.h"
+#include "render_state.h"
+#include "profiler.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <GL/glew.h>
 #include <iostream>
@@ -41,10 +45,17 @@ namespace game {
 
         geometry_ = geom;
         shader_ = shader;
+        view_matrix_id_ = shader->GetUniformId("view_matrix");
+        transformation_matrix_id_ = shader->GetUniformId("transformation_matrix");
+        color_override_id_ = shader->GetUniformId("color_override");
+        use_color_override_id_ = shader->GetUniformId("use_color_override");
     }
 
 
-    void MiniMap::Render(const std::vector<GameObject*>& game_objects, BossGameObject* boss) {
+    void MiniMap::Render(const EntityRegistry& entities) {
+        PROFILE_ZONE("MiniMap");
+        RenderPassScope pass(RenderPass::MINIMAP);
+
         // Make sure we have valid resources
         if (!geometry_ || !shader_ || shader_->GetShaderProgram() == 0) {
             std::cerr << "ERROR: MiniMap not properly initialized" << std::endl;
@@ -55,14 +66,8 @@ namespace game {
         static int frame_count = 0;
         frame_count++;
 
-        // Save OpenGL state
-        GLboolean depth_test_enabled;
-        glGetBooleanv(GL_DEPTH_TEST, &depth_test_enabled);
-
         // Set up rendering
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        RenderState::Overlay().Apply();
 
         // Get window size
         int window_width, window_height;
@@ -77,39 +82,41 @@ namespace game {
 
         // Enable shader
         shader_->Enable();
-        shader_->SetUniformMat4("view_matrix", projection);
+        shader_->SetUniformMat4(view_matrix_id_, projection);
 
         // Draw a simple background rectangle
         // Make background semi-transparent - USE CLASS VARIABLE
-        shader_->SetUniform3f("color_override", background_color_);
-        shader_->SetUniform1i("use_color_override", 1);
+        shader_->SetUniform3f(color_override_id_, background_color_);
+        shader_->SetUniform1i(use_color_override_id_, 1);
 
         glm::mat4 bg_transform = glm::translate(glm::mat4(1.0f), glm::vec3(pos_x_ + width_ / 2, pos_y_ + height_ / 2, 0.0f));
         bg_transform = glm::scale(bg_transform, glm::vec3(width_, height_, 1.0f));
-        shader_->SetUniformMat4("transformation_matrix", bg_transform);
+        shader_->SetUniformMat4(transformation_matrix_id_, bg_transform);
 
         // Draw background
         geometry_->SetGeometry(shader_->GetShaderProgram());
         glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+        RenderStats::CountDraw();
 
         // Draw border
         glm::vec3 border_color(1.0f, 1.0f, 1.0f);
-        shader_->SetUniform3f("color_override", border_color);
+        shader_->SetUniform3f(color_override_id_, border_color);
 
         // Very simple border (just a slightly larger rectangle)
         float border_size = 3.0f;
         glm::mat4 border_transform = glm::translate(glm::mat4(1.0f), glm::vec3(pos_x_ + width_ / 2, pos_y_ + height_ / 2, 0.0f));
         border_transform = glm::scale(border_transform, glm::vec3(width_ + border_size * 2, height_ + border_size * 2, 1.0f));
-        shader_->SetUniformMat4("transformation_matrix", border_transform);
+        shader_->SetUniformMat4(transformation_matrix_id_, border_transform);
 
         // Draw border
         glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+        RenderStats::CountDraw();
 
         // Now draw dots for game objects
-        // Get player first (always first object)
+        // Get player first
         PlayerGameObject* player = nullptr;
-        if (!game_objects.empty()) {
-            player = dynamic_cast<PlayerGameObject*>(game_objects[0]);
+        if (!entities.Players().Empty()) {
+            player = entities.Players()[0];
         }
 
         // If we have a player, draw all dots with positions relative to player
@@ -119,25 +126,23 @@ namespace game {
             DrawMapDot(player_pos, player_color_, 8.0f);
 
             // Draw enemy dots - USE CLASS VARIABLE
-            for (const auto& obj : game_objects) {
-                if (obj != player && dynamic_cast<EnemyGameObject*>(obj) && obj->IsActive()) {
-                    DrawMapDot(obj->GetPosition(), enemy_color_, 5.0f);
+            for (EnemyGameObject* enemy : entities.Enemies()) {
+                if (enemy->IsActive()) {
+                    DrawMapDot(enemy->GetPosition(), enemy_color_, 5.0f);
                 }
             }
 
             // Draw boss - USE CLASS VARIABLE instead of local variable
-            if (boss && boss->IsActive()) {
-                DrawMapDot(boss->GetPosition(), boss_color_, 10.0f);
+            for (BossGameObject* boss : entities.Bosses()) {
+                if (boss->IsActive()) {
+                    DrawMapDot(boss->GetPosition(), boss_color_, 10.0f);
+                }
             }
         }
 
         // Done, restore states
-        shader_->SetUniform1i("use_color_override", 0);
+        shader_->SetUniform1i(use_color_override_id_, 0);
         shader_->Disable();
-
-        if (depth_test_enabled) {
-            glEnable(GL_DEPTH_TEST);
-        }
     }
 
 
@@ -157,15 +162,16 @@ namespace game {
         float screen_y = pos_y_ + (norm_y * height_);
 
         // Set color for dot
-        shader_->SetUniform3f("color_override", color);
+        shader_->SetUniform3f(color_override_id_, color);
 
         // Create dot transformation
         glm::mat4 dot_transform = glm::translate(glm::mat4(1.0f), glm::vec3(screen_x, screen_y, 0.0f));
         dot_transform = glm::scale(dot_transform, glm::vec3(size, size, 1.0f));
-        shader_->SetUniformMat4("transformation_matrix", dot_transform);
+        shader_->SetUniformMat4(transformation_matrix_id_, dot_transform);
 
         // Draw dot
         glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+        RenderStats::CountDraw();
     }
 
-} // namespace game
\ No newline at end of file
+} // namespace game
\ No newline at end of file
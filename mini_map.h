@@ -14,6 +14,7 @@ namespace game {
     class PlayerGameObject;
     class EnemyGameObject;
     class BossGameObject;
+    class EntityRegistry;
 
     // Class for rendering a mini map in the corner of the screen
     class MiniMap {
@@ -25,7 +26,7 @@ namespace game {
         void Init(Geometry* geom, Shader* shader);
 
         // Render the mini map
-        void Render(const std::vector<GameObject*>& game_objects, BossGameObject* boss);
+        void Render(const EntityRegistry& entities);
 
         // Set the map position and size
         void SetPosition(float x, float y) { pos_x_ = x; pos_y_ = y; }
@@ -59,6 +60,10 @@ namespace game {
         // Geometry and shader for rendering
         Geometry* geometry_;
         Shader* shader_;
+        UniformId view_matrix_id_;
+        UniformId transformation_matrix_id_;
+        UniformId color_override_id_;
+        UniformId use_color_override_id_;
 
         // Colors for different entities
         glm::vec3 player_color_;
@@ -69,4 +74,4 @@ namespace game {
 
 } // namespace game
 
-#endif // MINI_MAP_H_
\ No newline at end of file
+#endif // MINI_MAP_H_
\ No newline at end of file
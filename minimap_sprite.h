@@ -33,6 +33,9 @@ namespace game {
                 2, 3, 0  // t2
             };
 
+            // The index buffer binding below would land in whatever vertex array is bound
+            glBindVertexArray(0);
+
             // Create buffer for vertices
             glGenBuffers(1, &vbo_);
             glBindBuffer(GL_ARRAY_BUFFER, vbo_);
@@ -45,43 +48,25 @@ namespace game {
 
             // Set number of elements in array buffer
             size_ = sizeof(face) / sizeof(GLuint);
-        }
 
-        // Use the geometry
-        void SetGeometry(GLuint shader_program) {
-            // No complex blending
-            glDisable(GL_DEPTH_TEST);
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            // Record the attribute layout once
+            CreateVertexArray();
+        }
 
+        // Describe the quad's attributes into the bound vertex array object
+        void SetupAttributes(void) {
             // Bind buffers
             glBindBuffer(GL_ARRAY_BUFFER, vbo_);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
 
-            // Verify shader program is valid
-            if (shader_program == 0) {
-                std::cerr << "ERROR: Invalid shader program in MinimapSprite::SetGeometry" << std::endl;
-                return;
-            }
-
-            // Set attributes for shaders - simple version to avoid errors
-            GLint vertex_att = glGetAttribLocation(shader_program, "vertex");
-            if (vertex_att >= 0) {
-                glVertexAttribPointer(vertex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
-                glEnableVertexAttribArray(vertex_att);
-            }
-
-            GLint color_att = glGetAttribLocation(shader_program, "color");
-            if (color_att >= 0) {
-                glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
-                glEnableVertexAttribArray(color_att);
-            }
-
-            GLint tex_att = glGetAttribLocation(shader_program, "uv");
-            if (tex_att >= 0) {
-                glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(5 * sizeof(GLfloat)));
-                glEnableVertexAttribArray(tex_att);
-            }
+            glVertexAttribPointer(ATTRIB_VERTEX, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
+            glEnableVertexAttribArray(ATTRIB_VERTEX);
+
+            glVertexAttribPointer(ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+            glEnableVertexAttribArray(ATTRIB_COLOR);
+
+            glVertexAttribPointer(ATTRIB_UV, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(5 * sizeof(GLfloat)));
+            glEnableVertexAttribArray(ATTRIB_UV);
         }
     };
 
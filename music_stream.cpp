@@ -0,0 +1,386 @@
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "music_stream.h"
+
+namespace game {
+
+    namespace {
+
+        const uint16_t WAVE_FORMAT_PCM = 1;
+        const uint16_t WAVE_FORMAT_IMA_ADPCM = 0x11;
+
+        // IMA ADPCM step sizes and how each code moves through them
+        const int ima_step_g[89] = {
+            7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+            50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+            253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+            1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+            3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+            11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+            32767
+        };
+        const int ima_index_g[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+        uint16_t ReadU16(const unsigned char* bytes) {
+            return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+        }
+
+        uint32_t ReadU32(const unsigned char* bytes) {
+            return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+                (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+        }
+
+        // Reads the data chunk of a RIFF WAVE file a block at a time,
+        // expanding IMA ADPCM blocks to 16 bit PCM
+        class WavDecoder : public MusicDecoder {
+        public:
+            bool Open(const std::string& path) {
+                file_.open(path, std::ios::binary);
+                if (!file_) {
+                    return false;
+                }
+
+                unsigned char header[12];
+                if (!file_.read(reinterpret_cast<char*>(header), 12) ||
+                    memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+                    return false;
+                }
+
+                // Walk the chunks up to the samples, picking up the format on the way
+                bool have_format = false;
+                while (true) {
+                    unsigned char chunk[8];
+                    if (!file_.read(reinterpret_cast<char*>(chunk), 8)) {
+                        return false;
+                    }
+                    uint32_t size = ReadU32(chunk + 4);
+                    if (memcmp(chunk, "fmt ", 4) == 0) {
+                        unsigned char format[16];
+                        if (size < 16 || !file_.read(reinterpret_cast<char*>(format), 16)) {
+                            return false;
+                        }
+                        format_tag_ = ReadU16(format);
+                        channels_ = ReadU16(format + 2);
+                        sample_rate_ = ReadU32(format + 4);
+                        block_align_ = ReadU16(format + 12);
+                        bits_ = ReadU16(format + 14);
+                        have_format = true;
+                        file_.seekg((size - 16) + (size & 1), std::ios::cur);
+                    }
+                    else if (memcmp(chunk, "data", 4) == 0) {
+                        data_start_ = file_.tellg();
+                        data_size_ = size;
+                        break;
+                    }
+                    else {
+                        // Chunks are padded to an even size
+                        file_.seekg(size + (size & 1), std::ios::cur);
+                    }
+                }
+
+                if (!have_format || (channels_ != 1 && channels_ != 2) || block_align_ == 0) {
+                    return false;
+                }
+                if (format_tag_ == WAVE_FORMAT_PCM) {
+                    if (bits_ != 8 && bits_ != 16) {
+                        return false;
+                    }
+                }
+                else if (format_tag_ == WAVE_FORMAT_IMA_ADPCM) {
+                    if (bits_ != 4 || block_align_ <= 4 * channels_) {
+                        return false;
+                    }
+                }
+                else {
+                    return false;
+                }
+
+                Rewind();
+                return true;
+            }
+
+            ALenum GetFormat(void) const override {
+                // ADPCM comes out as 16 bit PCM
+                bool wide = format_tag_ == WAVE_FORMAT_IMA_ADPCM || bits_ == 16;
+                if (channels_ == 1) {
+                    return wide ? AL_FORMAT_MONO16 : AL_FORMAT_MONO8;
+                }
+                return wide ? AL_FORMAT_STEREO16 : AL_FORMAT_STEREO8;
+            }
+
+            ALsizei GetSampleRate(void) const override {
+                return static_cast<ALsizei>(sample_rate_);
+            }
+
+            bool Read(std::vector<char>& out, size_t max_bytes) override {
+                out.clear();
+                if (remaining_ == 0) {
+                    return false;
+                }
+
+                if (format_tag_ == WAVE_FORMAT_PCM) {
+                    size_t bytes = std::max(max_bytes - max_bytes % block_align_, static_cast<size_t>(block_align_));
+                    bytes = std::min(bytes, static_cast<size_t>(remaining_));
+                    out.resize(bytes);
+                    file_.read(out.data(), bytes);
+                    out.resize(static_cast<size_t>(file_.gcount()));
+                    remaining_ = file_ ? remaining_ - static_cast<uint32_t>(bytes) : 0;
+                    return !out.empty();
+                }
+
+                // Whole ADPCM blocks, as many as fit
+                size_t block_samples = (block_align_ - 4 * channels_) * 2 / channels_ + 1;
+                size_t block_bytes = block_samples * channels_ * sizeof(int16_t);
+                do {
+                    size_t bytes = std::min(static_cast<size_t>(block_align_), static_cast<size_t>(remaining_));
+                    file_.read(reinterpret_cast<char*>(block_.data()), bytes);
+                    if (static_cast<size_t>(file_.gcount()) != bytes) {
+                        remaining_ = 0;
+                        break;
+                    }
+                    remaining_ -= static_cast<uint32_t>(bytes);
+                    DecodeBlock(bytes, out);
+                } while (remaining_ > 0 && out.size() + block_bytes <= max_bytes);
+                return !out.empty();
+            }
+
+            void Rewind(void) override {
+                file_.clear();
+                file_.seekg(data_start_);
+                remaining_ = data_size_;
+                block_.resize(block_align_);
+            }
+
+        private:
+            // Expand one ADPCM block, which may be cut short at the end of the file
+            void DecodeBlock(size_t bytes, std::vector<char>& out) {
+                if (bytes <= 4u * channels_) {
+                    return;
+                }
+                size_t samples = (bytes - 4 * channels_) * 2 / channels_ + 1;
+                size_t start = out.size();
+                out.resize(start + samples * channels_ * sizeof(int16_t));
+                int16_t* pcm = reinterpret_cast<int16_t*>(out.data() + start);
+
+                for (int c = 0; c < channels_; c++) {
+                    // Each channel opens with its first sample and step index
+                    const unsigned char* header = block_.data() + 4 * c;
+                    int predictor = static_cast<int16_t>(ReadU16(header));
+                    int index = std::min(static_cast<int>(header[2]), 88);
+                    pcm[c] = static_cast<int16_t>(predictor);
+
+                    // The rest come in runs of eight, four bytes per channel in turn
+                    size_t sample = 1;
+                    for (size_t offset = 4 * channels_ + 4 * c; offset + 4 <= bytes && sample < samples; offset += 4 * channels_) {
+                        for (int b = 0; b < 8 && sample < samples; b++, sample++) {
+                            int code = (block_[offset + b / 2] >> ((b & 1) * 4)) & 0xf;
+                            int step = ima_step_g[index];
+                            int diff = step >> 3;
+                            if (code & 4) diff += step;
+                            if (code & 2) diff += step >> 1;
+                            if (code & 1) diff += step >> 2;
+                            predictor += (code & 8) ? -diff : diff;
+                            predictor = std::min(std::max(predictor, -32768), 32767);
+                            index = std::min(std::max(index + ima_index_g[code], 0), 88);
+                            pcm[sample * channels_ + c] = static_cast<int16_t>(predictor);
+                        }
+                    }
+                }
+            }
+
+            std::ifstream file_;
+            uint16_t format_tag_ = 0;
+            uint16_t channels_ = 0;
+            uint32_t sample_rate_ = 0;
+            uint16_t block_align_ = 0;
+            uint16_t bits_ = 0;
+            std::streampos data_start_;
+            uint32_t data_size_ = 0;
+            uint32_t remaining_ = 0;        // Data bytes not read yet
+            std::vector<unsigned char> block_;
+        };
+
+    } // namespace
+
+
+    MusicDecoder* MusicDecoder::Open(const std::string& path) {
+        WavDecoder* decoder = new WavDecoder();
+        if (!decoder->Open(path)) {
+            delete decoder;
+            return nullptr;
+        }
+        return decoder;
+    }
+
+
+    MusicStream::MusicStream(void) : loop_(false), gain_(1.0f), source_(0), stopping_(false) {
+        for (int i = 0; i < BUFFER_COUNT; i++) {
+            buffers_[i] = 0;
+        }
+    }
+
+
+    MusicStream::~MusicStream() {
+        Close();
+    }
+
+
+    bool MusicStream::Open(const std::string& path, bool loop) {
+        Close();
+
+        decoder_.reset(MusicDecoder::Open(path));
+        if (!decoder_) {
+            std::cout << "Cannot stream music " << path << std::endl;
+            return false;
+        }
+        loop_ = loop;
+
+        alGenSources(1, &source_);
+        if (alGetError() != AL_NO_ERROR) {
+            source_ = 0;
+            decoder_.reset();
+            return false;
+        }
+        alGenBuffers(BUFFER_COUNT, buffers_);
+        if (alGetError() != AL_NO_ERROR) {
+            alDeleteSources(1, &source_);
+            source_ = 0;
+            decoder_.reset();
+            return false;
+        }
+        free_buffers_.assign(buffers_, buffers_ + BUFFER_COUNT);
+
+        // Music plays flat, wherever the listener is
+        alSource3f(source_, AL_POSITION, 0.0f, 0.0f, 0.0f);
+        alSource3f(source_, AL_VELOCITY, 0.0f, 0.0f, 0.0f);
+        alSourcef(source_, AL_ROLLOFF_FACTOR, 0.0f);
+        alSourcei(source_, AL_SOURCE_RELATIVE, AL_TRUE);
+        alSourcei(source_, AL_LOOPING, AL_FALSE);
+        alSourcef(source_, AL_GAIN, gain_);
+
+        stopping_ = false;
+        worker_ = std::thread(&MusicStream::DecodeMain, this);
+        return true;
+    }
+
+
+    void MusicStream::Close(void) {
+        if (worker_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            space_.notify_all();
+            worker_.join();
+        }
+        chunks_.clear();
+        decoder_.reset();
+
+        if (source_) {
+            // Stopping marks every queued buffer processed, so all unqueue
+            alSourceStop(source_);
+            alSourcei(source_, AL_BUFFER, 0);
+            alDeleteSources(1, &source_);
+            alDeleteBuffers(BUFFER_COUNT, buffers_);
+            source_ = 0;
+            for (int i = 0; i < BUFFER_COUNT; i++) {
+                buffers_[i] = 0;
+            }
+            free_buffers_.clear();
+        }
+    }
+
+
+    void MusicStream::DecodeMain(void) {
+        while (true) {
+            std::vector<char> chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                space_.wait(lock, [this] { return stopping_ || chunks_.size() < DECODE_AHEAD; });
+                if (stopping_) {
+                    return;
+                }
+                if (!spare_.empty()) {
+                    chunk.swap(spare_.back());
+                    spare_.pop_back();
+                }
+            }
+
+            // Wrap around once, a file that is still empty after that has
+            // nothing to play
+            bool more = decoder_->Read(chunk, CHUNK_BYTES);
+            if (!more && loop_) {
+                decoder_->Rewind();
+                more = decoder_->Read(chunk, CHUNK_BYTES);
+            }
+
+            if (!more) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            chunks_.push_back(std::move(chunk));
+        }
+    }
+
+
+    void MusicStream::Update(void) {
+        if (!source_) {
+            return;
+        }
+
+        // Take back the buffers the source is done with
+        ALint processed = 0;
+        alGetSourcei(source_, AL_BUFFERS_PROCESSED, &processed);
+        while (processed-- > 0) {
+            ALuint buffer;
+            alSourceUnqueueBuffers(source_, 1, &buffer);
+            free_buffers_.push_back(buffer);
+        }
+
+        // Refill them with whatever the worker has decoded
+        bool refilled = false;
+        while (!free_buffers_.empty()) {
+            std::vector<char> chunk;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (chunks_.empty()) {
+                    break;
+                }
+                chunk.swap(chunks_.front());
+                chunks_.pop_front();
+            }
+            space_.notify_one();
+
+            ALuint buffer = free_buffers_.back();
+            free_buffers_.pop_back();
+            alBufferData(buffer, decoder_->GetFormat(), chunk.data(), static_cast<ALsizei>(chunk.size()), decoder_->GetSampleRate());
+            alSourceQueueBuffers(source_, 1, &buffer);
+            refilled = true;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            spare_.push_back(std::move(chunk));
+        }
+
+        // A source that ran dry stops; start it again once it has data
+        if (refilled) {
+            ALint state;
+            alGetSourcei(source_, AL_SOURCE_STATE, &state);
+            if (state != AL_PLAYING) {
+                alSourcePlay(source_);
+            }
+        }
+    }
+
+
+    void MusicStream::SetGain(float gain) {
+        gain_ = gain;
+        if (source_) {
+            alSourcef(source_, AL_GAIN, gain_);
+        }
+    }
+
+} // namespace game
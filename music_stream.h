@@ -0,0 +1,93 @@
+#ifndef MUSIC_STREAM_H_
+#define MUSIC_STREAM_H_
+
+#include <AL/al.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace game {
+
+    // Turns a music file into PCM a chunk at a time
+    class MusicDecoder {
+    public:
+        virtual ~MusicDecoder() {}
+
+        // Decoder for a file, nullptr if it cannot be opened or its format
+        // is not supported
+        // WAV files holding PCM or IMA ADPCM (4:1 compressed) are supported
+        static MusicDecoder* Open(const std::string& path);
+
+        // OpenAL format and sample rate of the decoded PCM
+        virtual ALenum GetFormat(void) const = 0;
+        virtual ALsizei GetSampleRate(void) const = 0;
+
+        // Replace out with up to max_bytes of PCM, at least one block even
+        // if that is more; returns false at the end of the file
+        virtual bool Read(std::vector<char>& out, size_t max_bytes) = 0;
+
+        // Start over from the first sample
+        virtual void Rewind(void) = 0;
+    };
+
+    // Plays a music file without holding it in memory
+    // A worker thread decodes a few chunks ahead of playback, and Update(),
+    // called once per frame, feeds them to a small ring of OpenAL buffers
+    // queued on the stream's source. Buffers the source has finished with
+    // are refilled, so memory stays at a few chunks whatever the track length
+    class MusicStream {
+
+    public:
+        static const int BUFFER_COUNT = 4;          // AL buffers queued on the source
+        static const int DECODE_AHEAD = 4;          // Chunks the worker may run ahead
+        static const size_t CHUNK_BYTES = 32768;    // PCM per buffer, ~0.2 s of 44.1 kHz stereo
+
+        MusicStream(void);
+        ~MusicStream();
+
+        MusicStream(const MusicStream&) = delete;
+        MusicStream& operator=(const MusicStream&) = delete;
+
+        // Start streaming a file, replacing whatever was playing
+        // Returns false, and stays silent, if the file cannot be decoded
+        bool Open(const std::string& path, bool loop);
+
+        // Stop playback, the worker and free the AL objects
+        void Close(void);
+
+        // Refill the buffers the source has played, call once per frame
+        void Update(void);
+
+        void SetGain(float gain);
+        inline float GetGain(void) const { return gain_; }
+        inline bool IsOpen(void) const { return source_ != 0; }
+
+    private:
+        // Decode chunks until the file ends or the stream closes
+        void DecodeMain(void);
+
+        std::unique_ptr<MusicDecoder> decoder_;
+        bool loop_;
+        float gain_;
+
+        ALuint source_;
+        ALuint buffers_[BUFFER_COUNT];
+        std::vector<ALuint> free_buffers_;          // Buffers not queued on the source
+
+        // Chunks decoded but not queued yet, and emptied ones for reuse
+        std::thread worker_;
+        std::mutex mutex_;
+        std::condition_variable space_;
+        std::deque<std::vector<char>> chunks_;
+        std::vector<std::vector<char>> spare_;
+        bool stopping_;
+
+    }; // class MusicStream
+
+} // namespace game
+
+#endif // MUSIC_STREAM_H_
@@ -3,11 +3,11 @@
 
 // Attributes passed from the vertex shader
 in vec2 uv_interp;
+in float alpha_interp;
 
 // Uniform (global) buffer
 uniform sampler2D onetex;
 uniform float time;
-uniform float alpha = 1.0; // Default alpha value
 
 // Un-modulated color of fragment
 out vec4 FragmentColor;
@@ -22,7 +22,7 @@ void main()
     
     // Apply glow effect to color and alpha
     color.rgb *= glow;
-    color.a *= alpha;
+    color.a *= alpha_interp;
     
     // For flame particles - add orange/yellow gradient
     vec3 flame_color = vec3(1.0, 0.6 + 0.4 * sin(time * 5.0), 0.2);
@@ -14,6 +14,7 @@ namespace game {
         current_health_ = max_health_;
         collected_items_ = 0;
         is_invincible_ = false;
+        is_immortal_ = false;
         normal_texture_ = texture;
         invincible_texture_ = texture;
         speed_buff_ = 1.0f;  // Initialize speed buff
@@ -93,8 +94,11 @@ namespace game {
             std::cout << "=========================" << std::endl;
             std::cout << "Player destroyed after 3 hits!" << std::endl;
 
-            // Close the window
-            glfwSetWindowShouldClose(glfwGetCurrentContext(), GLFW_TRUE);
+            // Close the window, if there is one
+            GLFWwindow* window = glfwGetCurrentContext();
+            if (window) {
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+            }
             return;
         }
 
@@ -166,12 +170,6 @@ namespace game {
     // Implement SwitchWeapon method
     void PlayerGameObject::SwitchWeapon() {
 
-        // Verify textures are loaded before switching
-        if (missile_texture_ == 0) {
-            std::cout << "Warning: Cannot switch to missile weapon - texture not loaded" << std::endl;
-            return;
-        }
-
         // Check cooldown
         if (weapon_switch_cooldown_.Finished()) {
             // Toggle between weapon types
@@ -244,6 +242,10 @@ namespace game {
 
 
     void PlayerGameObject::TakeDamage(float damage) {
+        if (is_immortal_) {
+            return;
+        }
+
         // If invincible, don't take damage
         if (is_invincible_) {
             std::cout << "Damage blocked by invincibility shield!" << std::endl;
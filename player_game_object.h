@@ -59,6 +59,9 @@ namespace game {
 
         const Timer& GetInvincibilityTimer() const { return invincibility_timer_; }
 
+        // An immortal player ignores all damage (stress tests)
+        void SetImmortal(bool immortal) { is_immortal_ = immortal; }
+
         // Physics movement
         const glm::vec3& GetVelocity() const { return velocity_; }
         float GetMaxVelocity() const { return max_velocity_; }
@@ -90,6 +93,7 @@ namespace game {
         int damage_points_;             // Number of times the player can be hit
         int collected_items_;           // Number of items collected  
         bool is_invincible_;            // Flag to indicate if player is invincible
+        bool is_immortal_;              // Ignores damage altogether
         GLuint normal_texture_;         // Texture to use when not invincible
         GLuint invincible_texture_;     // Texture to use when invincible
         Timer invincibility_timer_;     // Timer to control invincibility duration
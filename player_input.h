@@ -0,0 +1,26 @@
+#ifndef PLAYER_INPUT_H_
+#define PLAYER_INPUT_H_
+
+#include <cstdint>
+
+namespace game {
+
+    // The player's commands for one simulation step, one bit per button
+    // The simulation reads these instead of the keyboard, so a recorded
+    // stream of them drives a replay exactly like the original match
+    typedef uint16_t PlayerInput;
+
+    enum PlayerInputButton : PlayerInput {
+        INPUT_FORWARD = 1 << 0,       // W
+        INPUT_BACKWARD = 1 << 1,      // S
+        INPUT_TURN_LEFT = 1 << 2,     // A
+        INPUT_TURN_RIGHT = 1 << 3,    // D
+        INPUT_STRAFE_LEFT = 1 << 4,   // Z
+        INPUT_STRAFE_RIGHT = 1 << 5,  // C
+        INPUT_FIRE = 1 << 6,          // Space
+        INPUT_SWITCH_WEAPON = 1 << 7  // Q
+    };
+
+} // namespace game
+
+#endif // PLAYER_INPUT_H_
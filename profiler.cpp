@@ -0,0 +1,201 @@
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <cstring>
+
+#include "profiler.h"
+
+namespace game {
+
+    // Stop logging past this many events rather than grow without bound,
+    // about 24 MB and several minutes of play
+    static const size_t MAX_TRACE_EVENTS = 1 << 20;
+
+    bool Profiler::enabled_ = true;
+    int Profiler::history_length_ = Profiler::HISTORY_FRAMES;
+    uint64_t Profiler::frame_count_ = 0;
+    double Profiler::frame_start_ = 0.0;
+    std::vector<Profiler::ZoneStats> Profiler::zones_;
+    std::vector<Profiler::OpenZone> Profiler::stack_;
+    bool Profiler::tracing_ = false;
+    std::string Profiler::trace_path_;
+    std::vector<Profiler::TraceEvent> Profiler::trace_;
+
+    double Profiler::NowMicroseconds(void) {
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    size_t Profiler::FindStats(const char* name, int depth) {
+        // A handful of zones, a linear scan is enough
+        for (size_t i = 0; i < zones_.size(); i++) {
+            if (zones_[i].name == name || std::strcmp(zones_[i].name, name) == 0) {
+                return i;
+            }
+        }
+        ZoneStats stats;
+        stats.name = name;
+        stats.depth = depth;
+        stats.frame_time = 0.0;
+        stats.history.assign(history_length_, 0.0f);
+        zones_.push_back(stats);
+        return zones_.size() - 1;
+    }
+
+    void Profiler::BeginFrame(void) {
+        if (!enabled_) {
+            return;
+        }
+        // The frame itself heads the table
+        FindStats("Frame", 0);
+        frame_start_ = NowMicroseconds();
+    }
+
+    void Profiler::EndFrame(void) {
+        if (!enabled_) {
+            return;
+        }
+        double now = NowMicroseconds();
+        if (tracing_ && trace_.size() < MAX_TRACE_EVENTS) {
+            trace_.push_back({ "Frame", frame_start_, now - frame_start_ });
+        }
+
+        // Zones that did not run this frame record zero
+        int slot = static_cast<int>(frame_count_ % history_length_);
+        zones_[FindStats("Frame", 0)].frame_time = now - frame_start_;
+        for (ZoneStats& stats : zones_) {
+            stats.history[slot] = static_cast<float>(stats.frame_time);
+            stats.frame_time = 0.0;
+        }
+        frame_count_++;
+    }
+
+    void Profiler::SetHistoryLength(int frames) {
+        history_length_ = std::max(1, frames);
+        Reset();
+    }
+
+    void Profiler::Reset(void) {
+        zones_.clear();
+        stack_.clear();
+        frame_count_ = 0;
+    }
+
+    void Profiler::BeginZone(const char* name) {
+        size_t stats = FindStats(name, static_cast<int>(stack_.size()) + 1);
+        stack_.push_back({ stats, NowMicroseconds() });
+    }
+
+    void Profiler::EndZone(void) {
+        if (stack_.empty()) {
+            return;
+        }
+        OpenZone zone = stack_.back();
+        stack_.pop_back();
+        double duration = NowMicroseconds() - zone.start;
+
+        ZoneStats& stats = zones_[zone.stats];
+        stats.frame_time += duration;
+
+        if (tracing_ && trace_.size() < MAX_TRACE_EVENTS) {
+            trace_.push_back({ stats.name, zone.start, duration });
+        }
+    }
+
+    void Profiler::StartTrace(const std::string& path) {
+        trace_path_ = path;
+        trace_.clear();
+        trace_.reserve(4096);
+        tracing_ = true;
+    }
+
+    void Profiler::StopTrace(void) {
+        if (!tracing_) {
+            return;
+        }
+        tracing_ = false;
+
+        std::ofstream file(trace_path_);
+        if (!file) {
+            std::cerr << "Cannot write trace file " << trace_path_ << std::endl;
+            return;
+        }
+
+        // Complete ("X") events on one thread, timestamps in microseconds
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << std::fixed << std::setprecision(3);
+        for (size_t i = 0; i < trace_.size(); i++) {
+            const TraceEvent& event = trace_[i];
+            file << "{\"name\":\"" << event.name << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":0,"
+                << "\"ts\":" << event.start << ",\"dur\":" << event.duration << "}"
+                << (i + 1 < trace_.size() ? ",\n" : "\n");
+        }
+        file << "]}\n";
+
+        std::cout << "Wrote " << trace_.size() << " trace events to " << trace_path_;
+        if (trace_.size() >= MAX_TRACE_EVENTS) {
+            std::cout << " (truncated)";
+        }
+        std::cout << std::endl;
+        trace_.clear();
+        trace_.shrink_to_fit();
+    }
+
+    std::vector<Profiler::ZoneSummary> Profiler::Summarize(void) {
+        std::vector<ZoneSummary> summaries;
+        int frames = static_cast<int>(std::min<uint64_t>(frame_count_, history_length_));
+        if (frames == 0) {
+            return summaries;
+        }
+
+        std::vector<float> sorted;
+        for (const ZoneStats& stats : zones_) {
+            sorted.assign(stats.history.begin(), stats.history.begin() + frames);
+            std::sort(sorted.begin(), sorted.end());
+            double sum = 0.0;
+            for (float t : sorted) {
+                sum += t;
+            }
+            auto percentile = [&](double p) {
+                return sorted[std::min(frames - 1, static_cast<int>(frames * p))] / 1000.0;
+            };
+
+            ZoneSummary summary;
+            summary.name = stats.name;
+            summary.depth = stats.depth;
+            summary.min = sorted.front() / 1000.0;
+            summary.avg = sum / frames / 1000.0;
+            summary.p50 = percentile(0.50);
+            summary.p90 = percentile(0.90);
+            summary.p99 = percentile(0.99);
+            summary.max = sorted.back() / 1000.0;
+            summaries.push_back(summary);
+        }
+        return summaries;
+    }
+
+    void Profiler::PrintTable(std::ostream& out) {
+        int frames = static_cast<int>(std::min<uint64_t>(frame_count_, history_length_));
+        if (frames == 0) {
+            return;
+        }
+
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        out << "Profile of the last " << frames << " frames (ms)" << std::endl;
+        out << "  " << std::left << std::setw(30) << "zone" << std::right
+            << std::setw(9) << "min" << std::setw(9) << "avg" << std::setw(9) << "p99" << std::endl;
+        out << std::fixed << std::setprecision(3);
+
+        for (const ZoneSummary& zone : Summarize()) {
+            std::string label = std::string(2 * zone.depth, ' ') + zone.name;
+            out << "  " << std::left << std::setw(30) << label << std::right
+                << std::setw(9) << zone.min << std::setw(9) << zone.avg << std::setw(9) << zone.p99 << std::endl;
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+} // namespace game
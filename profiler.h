@@ -0,0 +1,127 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace game {
+
+    // CPU time spent in named phases of a frame
+    // Zones nest and are timed with the steady clock. For every zone the
+    // profiler keeps its total time in each of the last GetHistoryLength()
+    // frames, from which PrintTable() reports min, average and 99th
+    // percentile. While a trace is open every zone is also logged as a
+    // Chrome trace_event, viewable in chrome://tracing or Perfetto
+    // Zone names must be string literals (or otherwise outlive the profiler)
+    class Profiler {
+    public:
+        static const int HISTORY_FRAMES = 240;
+
+        // Summary of one zone over the recorded frames, in milliseconds
+        struct ZoneSummary {
+            const char* name;
+            int depth;
+            double min, avg, p50, p90, p99, max;
+        };
+
+        // A disabled profiler skips every zone at the cost of one branch
+        static void SetEnabled(bool enabled) { enabled_ = enabled; }
+        static bool IsEnabled(void) { return enabled_; }
+
+        // Frame boundaries, zones are attributed to the frame they end in
+        static void BeginFrame(void);
+        static void EndFrame(void);
+        static inline uint64_t GetFrameCount(void) { return frame_count_; }
+
+        // Frames of history kept per zone (HISTORY_FRAMES by default)
+        // Changing it, like Reset(), drops every recorded frame
+        static void SetHistoryLength(int frames);
+        static inline int GetHistoryLength(void) { return history_length_; }
+        static void Reset(void);
+
+        // Time a zone, prefer ProfileZone or PROFILE_ZONE over calling these
+        static void BeginZone(const char* name);
+        static void EndZone(void);
+
+        // Log zones to a Chrome trace file, written out by StopTrace()
+        static void StartTrace(const std::string& path);
+        static void StopTrace(void);
+
+        // Every zone summarized over the recent frames, in first-seen order
+        static std::vector<ZoneSummary> Summarize(void);
+
+        // Per-zone min / avg / p99 of the recent frames, in milliseconds
+        static void PrintTable(std::ostream& out);
+
+    private:
+        // Rolling per-frame totals of one zone
+        struct ZoneStats {
+            const char* name;
+            int depth;                  // Nesting depth it was first seen at
+            double frame_time;          // Microseconds in the current frame
+            std::vector<float> history; // Per-frame totals, ring of history_length_
+        };
+
+        struct OpenZone {
+            size_t stats;               // Index in zones_
+            double start;               // Microseconds since the profiler started
+        };
+
+        struct TraceEvent {
+            const char* name;
+            double start;
+            double duration;
+        };
+
+        static double NowMicroseconds(void);
+        static size_t FindStats(const char* name, int depth);
+
+        static bool enabled_;
+        static int history_length_;
+        static uint64_t frame_count_;
+        static double frame_start_;
+        static std::vector<ZoneStats> zones_;
+        static std::vector<OpenZone> stack_;
+
+        static bool tracing_;
+        static std::string trace_path_;
+        static std::vector<TraceEvent> trace_;
+
+    }; // class Profiler
+
+    // Times the enclosing scope, or up to an earlier call to End()
+    class ProfileZone {
+    public:
+        explicit ProfileZone(const char* name) : open_(Profiler::IsEnabled()) {
+            if (open_) {
+                Profiler::BeginZone(name);
+            }
+        }
+        ~ProfileZone() { End(); }
+
+        void End(void) {
+            if (open_) {
+                Profiler::EndZone();
+                open_ = false;
+            }
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        bool open_;
+
+    }; // class ProfileZone
+
+} // namespace game
+
+#define PROFILE_ZONE_CONCAT_(a, b) a##b
+#define PROFILE_ZONE_NAME_(line) PROFILE_ZONE_CONCAT_(profile_zone_, line)
+
+// Time the rest of the enclosing scope
+#define PROFILE_ZONE(name) game::ProfileZone PROFILE_ZONE_NAME_(__LINE__)(name)
+
+#endif // PROFILER_H_
@@ -0,0 +1,50 @@
+#include "random.h"
+
+namespace game {
+
+    uint32_t Random::seed_ = 0;
+    std::mt19937 Random::streams_[static_cast<int>(RandomStream::STREAM_COUNT)];
+
+    void Random::Seed(uint32_t seed) {
+        seed_ = seed;
+        for (int i = 0; i < static_cast<int>(RandomStream::STREAM_COUNT); i++) {
+            // Mix the stream index in so neighbouring seeds don't share sequences
+            std::seed_seq sequence{ seed, static_cast<uint32_t>(i) };
+            streams_[i].seed(sequence);
+        }
+    }
+
+    float Random::Range(RandomStream stream, float min, float max) {
+        // The top 24 bits fill a float mantissa exactly
+        float t = (Next(stream) >> 8) * (1.0f / 16777216.0f);
+        return min + (max - min) * t;
+    }
+
+    int Random::Index(RandomStream stream, int count) {
+        if (count <= 0) {
+            return 0;
+        }
+        return static_cast<int>(Next(stream) % static_cast<uint32_t>(count));
+    }
+
+    uint32_t Random::Next(RandomStream stream) {
+        return static_cast<uint32_t>(streams_[static_cast<int>(stream)]());
+    }
+
+
+    float LocalRandom::Range(float min, float max) {
+        // Output is in [1, 2^31 - 2]; like Random::Range, keep the top 24 of
+        // its 31 bits, since scaling all of them can round up to 1
+        uint32_t value = static_cast<uint32_t>(engine_()) - 1;
+        float t = (value >> 7) * (1.0f / 16777216.0f);
+        return min + (max - min) * t;
+    }
+
+    int LocalRandom::Index(int count) {
+        if (count <= 0) {
+            return 0;
+        }
+        return static_cast<int>((static_cast<uint32_t>(engine_()) - 1) % static_cast<uint32_t>(count));
+    }
+
+} // namespace game
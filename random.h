@@ -0,0 +1,68 @@
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <cstdint>
+#include <random>
+
+namespace game {
+
+    // Independent random sequences, one per subsystem, so that drawing more
+    // numbers in one (say, a visual effect) never shifts another
+    enum class RandomStream : uint8_t {
+        SPAWN,          // Enemy and asteroid placement
+        COLLECTIBLES,   // Collectible placement
+        ASTEROIDS,      // Asteroid motion and collisions
+        ENEMY_AI,       // Enemy movement choices
+        EFFECTS,        // Purely visual, never affects the simulation
+        STREAM_COUNT
+    };
+
+    // Seeded random numbers for the whole game
+    // Every stream is derived from one master seed, so a match is fully
+    // determined by its seed and its player input. The helpers only use the
+    // raw output of mt19937, which the standard fixes, rather than the
+    // std distributions, whose results differ between standard libraries
+    class Random {
+    public:
+        // Restart every stream from a master seed
+        static void Seed(uint32_t seed);
+        static uint32_t GetSeed(void) { return seed_; }
+
+        // Uniform float in [min, max)
+        static float Range(RandomStream stream, float min, float max);
+
+        // Uniform integer in [0, count)
+        static int Index(RandomStream stream, int count);
+
+        // Raw 32 bit output, e.g. to seed a local generator
+        static uint32_t Next(RandomStream stream);
+
+    private:
+        static uint32_t seed_;
+        static std::mt19937 streams_[static_cast<int>(RandomStream::STREAM_COUNT)];
+
+    }; // class Random
+
+    // A small generator owned by one object, seeded from a stream when the
+    // object is created
+    // Objects updated in parallel draw from their own generator instead of a
+    // shared stream, so the numbers they get don't depend on thread timing
+    class LocalRandom {
+    public:
+        explicit LocalRandom(uint32_t seed = 1) : engine_(seed) {}
+
+        // Uniform float in [min, max)
+        float Range(float min, float max);
+
+        // Uniform integer in [0, count)
+        int Index(int count);
+
+    private:
+        // minstd_rand's output is fixed by the standard, like mt19937's
+        std::minstd_rand engine_;
+
+    }; // class LocalRandom
+
+} // namespace game
+
+#endif // RANDOM_H_
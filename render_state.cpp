@@ -0,0 +1,51 @@
+#include "render_state.h"
+
+namespace game {
+
+    // The state last applied to the (single) GL context
+    static RenderState current_state_g(true, true, RenderState::BLEND_NONE);
+    static bool current_state_valid_g = false;
+
+    void RenderState::Apply(void) const {
+        bool full = !current_state_valid_g;
+        const RenderState& current = current_state_g;
+
+        if (full || depth_test_ != current.depth_test_) {
+            if (depth_test_) {
+                glEnable(GL_DEPTH_TEST);
+                glDepthFunc(GL_LESS);
+            }
+            else {
+                glDisable(GL_DEPTH_TEST);
+            }
+        }
+
+        if (full || depth_write_ != current.depth_write_) {
+            glDepthMask(depth_write_ ? GL_TRUE : GL_FALSE);
+        }
+
+        if (full || blend_ != current.blend_) {
+            switch (blend_) {
+            case BLEND_NONE:
+                glDisable(GL_BLEND);
+                break;
+            case BLEND_ALPHA:
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                break;
+            case BLEND_ADDITIVE:
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+                break;
+            }
+        }
+
+        current_state_g = *this;
+        current_state_valid_g = true;
+    }
+
+    void RenderState::Invalidate(void) {
+        current_state_valid_g = false;
+    }
+
+} // namespace game
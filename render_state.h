@@ -0,0 +1,66 @@
+#ifndef RENDER_STATE_H_
+#define RENDER_STATE_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <cstdint>
+
+namespace game {
+
+    // Fixed-function state a draw needs: depth test, depth writes and blending
+    // Every draw applies one of these instead of toggling GL state directly, and
+    // Apply() only touches what differs from the last applied state
+    // States have a total order (by key), so queued draws can be sorted by state
+    class RenderState {
+
+    public:
+        enum Blend : uint8_t {
+            BLEND_NONE,
+            BLEND_ALPHA,     // src_alpha, one_minus_src_alpha
+            BLEND_ADDITIVE   // src_alpha, one
+        };
+
+        RenderState(bool depth_test, bool depth_write, Blend blend)
+            : depth_test_(depth_test), depth_write_(depth_write), blend_(blend) {}
+
+        // Opaque sprites; the first sprite drawn on a pixel wins (depth func GL_LESS)
+        static RenderState Opaque(void) { return RenderState(true, true, BLEND_NONE); }
+        // Alpha blended, but still claims its pixels like a sprite (text)
+        static RenderState Blended(void) { return RenderState(true, true, BLEND_ALPHA); }
+        // Alpha blended particles behind everything already drawn
+        static RenderState Translucent(void) { return RenderState(true, false, BLEND_ALPHA); }
+        // Glowing particles behind everything already drawn
+        static RenderState Additive(void) { return RenderState(true, false, BLEND_ADDITIVE); }
+        // Fills the screen first and leaves the depth buffer untouched
+        static RenderState Backdrop(void) { return RenderState(false, false, BLEND_NONE); }
+        // Screen-space UI on top of the scene
+        static RenderState Overlay(void) { return RenderState(false, false, BLEND_ALPHA); }
+
+        // Make this the current GL state
+        void Apply(void) const;
+
+        // Forget what is currently applied (e.g. after a context change)
+        static void Invalidate(void);
+
+        // Sort key, states with equal keys are identical
+        inline uint32_t GetKey(void) const {
+            return (depth_test_ ? 4u : 0u) | (depth_write_ ? 2u : 0u) | (static_cast<uint32_t>(blend_) << 3);
+        }
+        inline bool operator<(const RenderState& other) const { return GetKey() < other.GetKey(); }
+        inline bool operator==(const RenderState& other) const { return GetKey() == other.GetKey(); }
+        inline bool operator!=(const RenderState& other) const { return GetKey() != other.GetKey(); }
+
+        inline bool HasDepthTest(void) const { return depth_test_; }
+        inline bool HasDepthWrite(void) const { return depth_write_; }
+        inline Blend GetBlend(void) const { return blend_; }
+
+    private:
+        bool depth_test_;
+        bool depth_write_;
+        Blend blend_;
+
+    }; // class RenderState
+
+} // namespace game
+
+#endif // RENDER_STATE_H_
@@ -0,0 +1,252 @@
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+
+#include "render_stats.h"
+
+namespace game {
+
+    bool RenderStats::initialized_ = false;
+    bool RenderStats::timers_ = false;
+    uint64_t RenderStats::frame_number_ = 0;
+    uint64_t RenderStats::late_frames_ = 0;
+    RenderStats::Frame RenderStats::frames_[FRAME_LATENCY];
+    RenderStats::Frame* RenderStats::recording_ = nullptr;
+    bool RenderStats::interval_open_ = false;
+    int RenderStats::stack_[8];
+    int RenderStats::depth_ = 0;
+    RenderStats::PassStats RenderStats::counters_[PASSES];
+    RenderStats::PassStats RenderStats::latest_[PASSES];
+    std::ofstream RenderStats::csv_;
+
+    static const char* pass_names_g[] = {
+        "other", "background", "sprites", "space_dust", "flames", "health_bar", "minimap"
+    };
+    static_assert(sizeof(pass_names_g) / sizeof(pass_names_g[0]) == static_cast<size_t>(RenderPass::PASS_COUNT),
+        "Every render pass needs a name");
+
+    const char* RenderStats::GetPassName(RenderPass pass) {
+        return pass_names_g[static_cast<int>(pass)];
+    }
+
+    void RenderStats::Init(void) {
+        if (initialized_) {
+            return;
+        }
+        // Core since OpenGL 3.3
+        timers_ = GLEW_ARB_timer_query ? true : false;
+        for (Frame& frame : frames_) {
+            frame.pending = false;
+            frame.interval_count = 0;
+            for (Interval& interval : frame.intervals) {
+                interval.pass = 0;
+                interval.query = 0;
+            }
+            if (timers_) {
+                GLuint queries[MAX_INTERVALS];
+                glGenQueries(MAX_INTERVALS, queries);
+                for (int i = 0; i < MAX_INTERVALS; i++) {
+                    frame.intervals[i].query = queries[i];
+                }
+            }
+        }
+        for (PassStats& pass : latest_) {
+            pass = PassStats{ -1.0, 0, 0, 0, 0 };
+        }
+        if (!timers_) {
+            std::cout << "Timer queries not supported, GPU pass times unavailable" << std::endl;
+        }
+        initialized_ = true;
+    }
+
+    void RenderStats::Shutdown(void) {
+        StopCsv();
+        if (!initialized_) {
+            return;
+        }
+        if (timers_) {
+            for (Frame& frame : frames_) {
+                for (Interval& interval : frame.intervals) {
+                    glDeleteQueries(1, &interval.query);
+                }
+            }
+        }
+        initialized_ = false;
+    }
+
+    void RenderStats::BeginFrame(void) {
+        std::memset(counters_, 0, sizeof(counters_));
+        depth_ = 0;
+        if (!initialized_) {
+            recording_ = nullptr;
+            return;
+        }
+
+        // Read back the oldest frame if the GPU is done with it, its
+        // queries are reused for this frame either way
+        Frame& frame = frames_[frame_number_ % FRAME_LATENCY];
+        if (frame.pending) {
+            Resolve(frame);
+        }
+
+        frame.number = frame_number_;
+        frame.interval_count = 0;
+        frame.pending = true;
+        recording_ = &frame;
+        interval_open_ = false;
+    }
+
+    void RenderStats::EndFrame(void) {
+        while (depth_ > 0) {
+            EndPass();
+        }
+        if (recording_) {
+            std::memcpy(recording_->passes, counters_, sizeof(counters_));
+            // Without timers the counters are complete right away
+            if (!timers_) {
+                Resolve(*recording_);
+            }
+            recording_ = nullptr;
+        }
+        frame_number_++;
+    }
+
+    void RenderStats::BeginPass(RenderPass pass) {
+        if (depth_ == static_cast<int>(sizeof(stack_) / sizeof(stack_[0]))) {
+            return;
+        }
+        StopInterval();
+        stack_[depth_++] = static_cast<int>(pass);
+        StartInterval(Current());
+    }
+
+    void RenderStats::EndPass(void) {
+        if (depth_ == 0) {
+            return;
+        }
+        StopInterval();
+        depth_--;
+        // Resume the pass this one interrupted
+        if (depth_ > 0) {
+            StartInterval(Current());
+        }
+    }
+
+    void RenderStats::StartInterval(int pass) {
+        if (!timers_ || !recording_ || recording_->interval_count == MAX_INTERVALS) {
+            return;
+        }
+        Interval& interval = recording_->intervals[recording_->interval_count];
+        interval.pass = static_cast<uint8_t>(pass);
+        glBeginQuery(GL_TIME_ELAPSED, interval.query);
+        interval_open_ = true;
+    }
+
+    void RenderStats::StopInterval(void) {
+        if (!interval_open_) {
+            return;
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+        recording_->interval_count++;
+        interval_open_ = false;
+    }
+
+    void RenderStats::Resolve(Frame& frame) {
+        frame.pending = false;
+        for (PassStats& pass : frame.passes) {
+            pass.gpu_ms = timers_ ? 0.0 : -1.0;
+        }
+
+        if (timers_ && frame.interval_count > 0) {
+            // Queries complete in order, so the last one stands for all
+            GLuint available = 0;
+            glGetQueryObjectuiv(frame.intervals[frame.interval_count - 1].query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                late_frames_++;
+                return;
+            }
+            for (int i = 0; i < frame.interval_count; i++) {
+                GLuint64 nanoseconds = 0;
+                glGetQueryObjectui64v(frame.intervals[i].query, GL_QUERY_RESULT, &nanoseconds);
+                frame.passes[frame.intervals[i].pass].gpu_ms += nanoseconds / 1.0e6;
+            }
+        }
+
+        std::memcpy(latest_, frame.passes, sizeof(latest_));
+
+        if (csv_.is_open()) {
+            csv_ << frame.number;
+            for (const PassStats& pass : frame.passes) {
+                csv_ << "," << pass.gpu_ms << "," << pass.draws << "," << pass.shader_switches
+                    << "," << pass.texture_binds << "," << pass.uniform_uploads;
+            }
+            csv_ << "\n";
+        }
+    }
+
+    double RenderStats::GetGpuFrameMs(void) {
+        double total = 0.0;
+        for (const PassStats& pass : latest_) {
+            if (pass.gpu_ms < 0.0) {
+                return -1.0;
+            }
+            total += pass.gpu_ms;
+        }
+        return total;
+    }
+
+    int RenderStats::GetDrawCount(void) {
+        int total = 0;
+        for (const PassStats& pass : latest_) {
+            total += pass.draws;
+        }
+        return total;
+    }
+
+    void RenderStats::StartCsv(const std::string& path) {
+        StopCsv();
+        csv_.open(path);
+        if (!csv_) {
+            std::cerr << "Cannot write render stats file " << path << std::endl;
+            return;
+        }
+        csv_ << "frame";
+        for (int i = 0; i < PASSES; i++) {
+            const char* name = pass_names_g[i];
+            csv_ << "," << name << "_gpu_ms," << name << "_draws," << name << "_shaders,"
+                << name << "_textures," << name << "_uniforms";
+        }
+        csv_ << "\n";
+    }
+
+    void RenderStats::StopCsv(void) {
+        if (csv_.is_open()) {
+            csv_.close();
+        }
+    }
+
+    void RenderStats::PrintTable(std::ostream& out) {
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        out << "Render passes (latest complete frame, " << late_frames_ << " frames late so far)" << std::endl;
+        out << "  " << std::left << std::setw(12) << "pass" << std::right << std::setw(9) << "gpu ms"
+            << std::setw(7) << "draws" << std::setw(9) << "shaders" << std::setw(10) << "textures"
+            << std::setw(10) << "uniforms" << std::endl;
+        out << std::fixed << std::setprecision(3);
+        for (int i = 0; i < PASSES; i++) {
+            const PassStats& pass = latest_[i];
+            out << "  " << std::left << std::setw(12) << pass_names_g[i] << std::right << std::setw(9);
+            if (pass.gpu_ms < 0.0) {
+                out << "n/a";
+            }
+            else {
+                out << pass.gpu_ms;
+            }
+            out << std::setw(7) << pass.draws << std::setw(9) << pass.shader_switches
+                << std::setw(10) << pass.texture_binds << std::setw(10) << pass.uniform_uploads << std::endl;
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+} // namespace game
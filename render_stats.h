@@ -0,0 +1,134 @@
+#ifndef RENDER_STATS_H_
+#define RENDER_STATS_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <ostream>
+
+namespace game {
+
+    // The parts of a frame whose GPU cost is measured separately
+    enum class RenderPass : uint8_t {
+        OTHER,          // Anything drawn outside a named pass
+        BACKGROUND,
+        SPRITES,        // Batched sprites and objects that draw themselves
+        SPACE_DUST,
+        FLAMES,
+        HEALTH_BAR,
+        MINIMAP,
+        PASS_COUNT
+    };
+
+    // GPU time and GL call counts of each render pass
+    // Passes are timed with GL_TIME_ELAPSED queries. A pass that starts inside
+    // another one suspends it, so every interval is charged to exactly one
+    // pass and queries never nest. Results are read back FRAME_LATENCY frames
+    // later, and only if the GPU already has them, so reading never stalls;
+    // a frame whose results are still pending is dropped and counted late.
+    // The draw sites report draws, shader switches, texture binds and uniform
+    // uploads, which are charged to the innermost open pass
+    class RenderStats {
+    public:
+        static const int FRAME_LATENCY = 4;
+        static const int MAX_INTERVALS = 64;   // Pass intervals timed per frame
+
+        struct PassStats {
+            double gpu_ms;      // Negative when no timing is available
+            int draws;
+            int shader_switches;
+            int texture_binds;
+            int uniform_uploads;
+        };
+
+        // Create the queries, call once the GL context exists
+        // Without timer query support only the counters are kept
+        static void Init(void);
+        static void Shutdown(void);
+
+        // Frame boundaries, collect whatever results the GPU has finished
+        static void BeginFrame(void);
+        static void EndFrame(void);
+
+        // Open and close a pass, prefer RenderPassScope
+        static void BeginPass(RenderPass pass);
+        static void EndPass(void);
+
+        // Reported by the draw sites
+        static inline void CountDraw(void) { counters_[Current()].draws++; }
+        static inline void CountShaderSwitch(void) { counters_[Current()].shader_switches++; }
+        static inline void CountTextureBind(void) { counters_[Current()].texture_binds++; }
+        static inline void CountUniformUpload(void) { counters_[Current()].uniform_uploads++; }
+
+        // Latest complete frame: counters with their GPU times
+        static const PassStats& GetPass(RenderPass pass) { return latest_[static_cast<int>(pass)]; }
+        static double GetGpuFrameMs(void);
+        static int GetDrawCount(void);
+        static inline uint64_t GetLateFrames(void) { return late_frames_; }
+        static inline bool HasTimers(void) { return timers_; }
+
+        // Write one line per resolved frame to a CSV file
+        static void StartCsv(const std::string& path);
+        static void StopCsv(void);
+
+        // Table of the latest complete frame
+        static void PrintTable(std::ostream& out);
+
+        static const char* GetPassName(RenderPass pass);
+
+    private:
+        static const int PASSES = static_cast<int>(RenderPass::PASS_COUNT);
+
+        // One interval of one pass, timed by one query
+        struct Interval {
+            uint8_t pass;
+            GLuint query;
+        };
+
+        // Everything recorded for a frame until its queries are read back
+        struct Frame {
+            uint64_t number;
+            bool pending;
+            int interval_count;
+            Interval intervals[MAX_INTERVALS];
+            PassStats passes[PASSES];
+        };
+
+        static inline int Current(void) { return depth_ > 0 ? stack_[depth_ - 1] : 0; }
+        static void StartInterval(int pass);
+        static void StopInterval(void);
+        static void Resolve(Frame& frame);
+
+        static bool initialized_;
+        static bool timers_;
+        static uint64_t frame_number_;
+        static uint64_t late_frames_;
+        static Frame frames_[FRAME_LATENCY];
+        static Frame* recording_;
+        static bool interval_open_;
+
+        static int stack_[8];
+        static int depth_;
+        static PassStats counters_[PASSES];
+        static PassStats latest_[PASSES];
+
+        static std::ofstream csv_;
+
+    }; // class RenderStats
+
+    // Charges the enclosing scope to a render pass
+    class RenderPassScope {
+    public:
+        explicit RenderPassScope(RenderPass pass) { RenderStats::BeginPass(pass); }
+        ~RenderPassScope() { RenderStats::EndPass(); }
+
+        RenderPassScope(const RenderPassScope&) = delete;
+        RenderPassScope& operator=(const RenderPassScope&) = delete;
+
+    }; // class RenderPassScope
+
+} // namespace game
+
+#endif // RENDER_STATS_H_
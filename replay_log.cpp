@@ -0,0 +1,121 @@
+#include <stdexcept>
+#include <cstring>
+
+#include "replay_log.h"
+
+namespace game {
+
+    static const char REPLAY_MAGIC[4] = { 'S', 'F', 'R', 'P' };
+    static const uint32_t REPLAY_VERSION = 1;
+    static const uint32_t REPLAY_END_MARKER = 0xFFFFFFFFu;
+
+    template <typename T>
+    static void WriteValue(std::ofstream& file, T value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static bool ReadValue(std::ifstream& file, T& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+
+    ReplayWriter::ReplayWriter(void) {
+        last_input_ = 0;
+        has_input_ = false;
+    }
+
+    ReplayWriter::~ReplayWriter() {
+        if (file_.is_open()) {
+            file_.close();
+        }
+    }
+
+    void ReplayWriter::Open(const std::string& path, uint32_t seed, double step) {
+        file_.open(path, std::ios::binary | std::ios::trunc);
+        if (!file_) {
+            throw std::runtime_error("Cannot create replay file " + path);
+        }
+        file_.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+        WriteValue(file_, REPLAY_VERSION);
+        WriteValue(file_, seed);
+        WriteValue(file_, step);
+        file_.flush();
+        has_input_ = false;
+    }
+
+    void ReplayWriter::Record(uint32_t step, PlayerInput input) {
+        if (!file_.is_open() || (has_input_ && input == last_input_)) {
+            return;
+        }
+        WriteValue(file_, step);
+        WriteValue(file_, input);
+        // Changes are rare, flushing each one keeps the file usable after a crash
+        file_.flush();
+        last_input_ = input;
+        has_input_ = true;
+    }
+
+    void ReplayWriter::Close(uint32_t total_steps) {
+        if (!file_.is_open()) {
+            return;
+        }
+        WriteValue(file_, REPLAY_END_MARKER);
+        WriteValue(file_, total_steps);
+        file_.close();
+    }
+
+
+    ReplayReader::ReplayReader(void) {
+        loaded_ = false;
+        seed_ = 0;
+        step_ = 0.0;
+        step_count_ = 0;
+        cursor_ = 0;
+        input_ = 0;
+    }
+
+    void ReplayReader::Load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Cannot open replay file " + path);
+        }
+
+        char magic[sizeof(REPLAY_MAGIC)];
+        uint32_t version;
+        if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, REPLAY_MAGIC, sizeof(magic)) != 0 ||
+            !ReadValue(file, version) || version != REPLAY_VERSION ||
+            !ReadValue(file, seed_) || !ReadValue(file, step_) || !(step_ > 0.0)) {
+            throw std::runtime_error("Invalid replay file " + path);
+        }
+
+        changes_.clear();
+        step_count_ = 0;
+        uint32_t step;
+        while (ReadValue(file, step)) {
+            if (step == REPLAY_END_MARKER) {
+                ReadValue(file, step_count_);
+                break;
+            }
+            Change change;
+            change.step = step;
+            if (!ReadValue(file, change.input)) {
+                break;
+            }
+            changes_.push_back(change);
+        }
+
+        cursor_ = 0;
+        input_ = 0;
+        loaded_ = true;
+    }
+
+    PlayerInput ReplayReader::InputAt(uint32_t step) {
+        while (cursor_ < changes_.size() && changes_[cursor_].step <= step) {
+            input_ = changes_[cursor_].input;
+            cursor_++;
+        }
+        return input_;
+    }
+
+} // namespace game
@@ -0,0 +1,83 @@
+#ifndef REPLAY_LOG_H_
+#define REPLAY_LOG_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "player_input.h"
+
+namespace game {
+
+    // Binary replay files
+    // A match is fully determined by its random seed, its simulation step
+    // and the player input of every step, so that is all a replay stores:
+    //   header   "SFRP", uint32 version, uint32 seed, float64 step seconds
+    //   change   uint32 step, uint16 input     (only when the input changes)
+    //   end      uint32 0xFFFFFFFF, uint32 total steps
+    // Values are written in the host's byte order (little-endian on every
+    // platform we build for). A file cut short by a crash has no end record
+    // but still replays up to its last change
+
+    // Writes a replay while a match is played
+    class ReplayWriter {
+    public:
+        ReplayWriter(void);
+        ~ReplayWriter();
+
+        // Create the file and write the header, throws on failure
+        void Open(const std::string& path, uint32_t seed, double step);
+
+        // Note the input of a step, steps must be passed in order
+        void Record(uint32_t step, PlayerInput input);
+
+        // Write the end record and close the file
+        void Close(uint32_t total_steps);
+
+        inline bool IsOpen(void) const { return file_.is_open(); }
+
+    private:
+        std::ofstream file_;
+        PlayerInput last_input_;
+        bool has_input_;
+
+    }; // class ReplayWriter
+
+    // Reads a replay back for re-simulation
+    class ReplayReader {
+    public:
+        ReplayReader(void);
+
+        // Read the whole file, throws on a missing or malformed file
+        void Load(const std::string& path);
+
+        inline bool IsLoaded(void) const { return loaded_; }
+        inline uint32_t GetSeed(void) const { return seed_; }
+        inline double GetStep(void) const { return step_; }
+
+        // Number of steps in the match, 0 if the file has no end record
+        inline uint32_t GetStepCount(void) const { return step_count_; }
+
+        // Input of a step, steps must be asked for in order
+        PlayerInput InputAt(uint32_t step);
+
+    private:
+        struct Change {
+            uint32_t step;
+            PlayerInput input;
+        };
+
+        bool loaded_;
+        uint32_t seed_;
+        double step_;
+        uint32_t step_count_;
+        std::vector<Change> changes_;
+        size_t cursor_;     // Next change to apply
+        PlayerInput input_; // Input in effect at the last step asked for
+
+    }; // class ReplayReader
+
+} // namespace game
+
+#endif // REPLAY_LOG_H_
@@ -1,12 +1,18 @@
 #include <iostream>
 #include <string>
+#include <cstring>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "file_utils.h"
+#include "geometry.h"
 #include "shader.h"
+#include "render_stats.h"
 
 namespace game {
 
+// Program last passed to glUseProgram, so re-enabling it is free
+static GLuint bound_program_g = 0;
+
 Shader::Shader(void)
 {
     // Don't do work in the constructor, leave it for the Init() function
@@ -59,6 +65,20 @@ void Shader::Init(const char *vertPath, const char *fragPath)
     shader_program_ = glCreateProgram();
     glAttachShader(shader_program_, vs);
     glAttachShader(shader_program_, fs);
+
+    // Pin the attribute locations so geometry VAOs work with every shader
+    // Names a shader does not use are ignored
+    glBindAttribLocation(shader_program_, ATTRIB_VERTEX, "vertex");
+    glBindAttribLocation(shader_program_, ATTRIB_COLOR, "color");
+    glBindAttribLocation(shader_program_, ATTRIB_UV, "uv");
+    glBindAttribLocation(shader_program_, ATTRIB_INSTANCE_0, "instance_position_angle");
+    glBindAttribLocation(shader_program_, ATTRIB_INSTANCE_1, "instance_scale_ghost");
+    glBindAttribLocation(shader_program_, ATTRIB_INSTANCE_2, "instance_uv_layer");
+    glBindAttribLocation(shader_program_, ATTRIB_INSTANCE_0, "dust_motion");
+    glBindAttribLocation(shader_program_, ATTRIB_INSTANCE_1, "dust_look");
+    glBindAttribLocation(shader_program_, ATTRIB_INSTANCE_0, "flame_transform");
+    glBindAttribLocation(shader_program_, ATTRIB_INSTANCE_1, "flame_alpha");
+
     glLinkProgram(shader_program_);
 
     // Check if shaders were linked successfully
@@ -73,61 +93,155 @@ void Shader::Init(const char *vertPath, const char *fragPath)
     // and linked
     glDeleteShader(vs);
     glDeleteShader(fs);
+
+    // Resolve uniform locations once instead of on every set
+    CacheUniforms();
 }
 
 
-void Shader::SetUniform1i(const GLchar *name, int value)
+void Shader::CacheUniforms(void)
 {
+    // Handles given out before linking keep their slots and get a location
+    for (UniformSlot& slot : uniforms_) {
+        slot.location = glGetUniformLocation(shader_program_, slot.name.c_str());
+        slot.has_value = false;
+    }
 
-    glUniform1i(glGetUniformLocation(shader_program_, name), value);
+    GLint count = 0;
+    glGetProgramiv(shader_program_, GL_ACTIVE_UNIFORMS, &count);
+    for (GLint i = 0; i < count; i++) {
+        GLchar name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(shader_program_, i, sizeof(name), &length, &size, &type, name);
+
+        // Arrays are reported as "name[0]", store them under their plain name
+        std::string uniform_name(name, length);
+        size_t bracket = uniform_name.find('[');
+        if (bracket != std::string::npos) {
+            uniform_name.resize(bracket);
+        }
+
+        bool known = false;
+        for (const UniformSlot& slot : uniforms_) {
+            known = known || slot.name == uniform_name;
+        }
+        if (!known) {
+            UniformSlot slot;
+            slot.name = uniform_name;
+            slot.location = glGetUniformLocation(shader_program_, name);
+            slot.has_value = false;
+            uniforms_.push_back(slot);
+        }
+    }
 }
 
 
-void Shader::SetUniform1f(const GLchar *name, float value)
+UniformId Shader::GetUniformId(const GLchar *name)
 {
+    // A shader has a handful of uniforms, a linear scan beats hashing here
+    for (size_t i = 0; i < uniforms_.size(); i++) {
+        if (strcmp(uniforms_[i].name.c_str(), name) == 0) {
+            return static_cast<UniformId>(i);
+        }
+    }
 
-    glUniform1f(glGetUniformLocation(shader_program_, name), value);
+    // Not active in the program (or optimized out): remember the miss
+    // Before Init() there is no program, the location is found on linking
+    UniformSlot slot;
+    slot.name = name;
+    slot.location = shader_program_ ? glGetUniformLocation(shader_program_, name) : -1;
+    slot.has_value = false;
+    uniforms_.push_back(slot);
+    return static_cast<UniformId>(uniforms_.size() - 1);
 }
 
 
-void Shader::SetUniform2f(const GLchar *name, const glm::vec2 &vector)
+bool Shader::Changed(UniformSlot& slot, const void* data, size_t size)
 {
-
-    glUniform2f(glGetUniformLocation(shader_program_, name), vector.x, vector.y);
+    if (slot.location == -1) {
+        return false;
+    }
+    if (slot.has_value && memcmp(slot.value, data, size) == 0) {
+        return false;
+    }
+    memcpy(slot.value, data, size);
+    slot.has_value = true;
+    RenderStats::CountUniformUpload();
+    return true;
 }
 
 
-void Shader::SetUniform3f(const GLchar *name, const glm::vec3 &vector)
+void Shader::SetUniform1i(UniformId id, int value)
 {
+    UniformSlot& slot = uniforms_[id];
+    if (Changed(slot, &value, sizeof(value))) {
+        glUniform1i(slot.location, value);
+    }
+}
 
-    glUniform3f(glGetUniformLocation(shader_program_, name), vector.x, vector.y, vector.z);
+
+void Shader::SetUniform1f(UniformId id, float value)
+{
+    UniformSlot& slot = uniforms_[id];
+    if (Changed(slot, &value, sizeof(value))) {
+        glUniform1f(slot.location, value);
+    }
 }
 
 
-void Shader::SetUniform4f(const GLchar *name, const glm::vec4 &vector)
+void Shader::SetUniform2f(UniformId id, const glm::vec2 &vector)
 {
+    UniformSlot& slot = uniforms_[id];
+    GLfloat data[2] = { vector.x, vector.y };
+    if (Changed(slot, data, sizeof(data))) {
+        glUniform2f(slot.location, vector.x, vector.y);
+    }
+}
 
-    glUniform4f(glGetUniformLocation(shader_program_, name), vector.x, vector.y, vector.z, vector.w);
+
+void Shader::SetUniform3f(UniformId id, const glm::vec3 &vector)
+{
+    UniformSlot& slot = uniforms_[id];
+    GLfloat data[3] = { vector.x, vector.y, vector.z };
+    if (Changed(slot, data, sizeof(data))) {
+        glUniform3f(slot.location, vector.x, vector.y, vector.z);
+    }
 }
 
 
-void Shader::SetUniformMat4(const GLchar *name, const glm::mat4 &matrix)
+void Shader::SetUniform4f(UniformId id, const glm::vec4 &vector)
 {
+    UniformSlot& slot = uniforms_[id];
+    GLfloat data[4] = { vector.x, vector.y, vector.z, vector.w };
+    if (Changed(slot, data, sizeof(data))) {
+        glUniform4f(slot.location, vector.x, vector.y, vector.z, vector.w);
+    }
+}
 
-    glUniformMatrix4fv(glGetUniformLocation(shader_program_, name), 1, GL_FALSE, glm::value_ptr(matrix));
+
+void Shader::SetUniformMat4(UniformId id, const glm::mat4 &matrix)
+{
+    UniformSlot& slot = uniforms_[id];
+    if (Changed(slot, glm::value_ptr(matrix), 16 * sizeof(GLfloat))) {
+        glUniformMatrix4fv(slot.location, 1, GL_FALSE, glm::value_ptr(matrix));
+    }
 }
 
+
 // void Shader::SetUniformIntArray(const GLchar *name, int len, const GLint *data)
 // {
 
 //     glUniform1iv(glGetUniformLocation(shader_program_, name), len, data);
 // }
 
-void Shader::SetUniformIntArray(const GLchar* name, int count, const GLint* array) {
+void Shader::SetUniformIntArray(UniformId id, int count, const GLint* array) {
     // Clear any previous errors first
     while (glGetError() != GL_NO_ERROR) {}
 
-    GLint loc = glGetUniformLocation(shader_program_, name);
+    const std::string& name = uniforms_[id].name;
+    GLint loc = uniforms_[id].location;
     if (loc == -1) {
         std::cerr << "Warning: Uniform '" << name << "' not found in shader program " << shader_program_ << std::endl;
         return;
@@ -135,6 +249,7 @@ void Shader::SetUniformIntArray(const GLchar* name, int count, const GLint* arra
 
     // Always pass the full array size to the shader
     glUniform1iv(loc, count, array);
+    RenderStats::CountUniformUpload();
 
     // Check for errors after setting the uniform
     GLenum err = glGetError();
@@ -147,14 +262,25 @@ void Shader::SetUniformIntArray(const GLchar* name, int count, const GLint* arra
 Shader::~Shader() 
 {
 
-    glDeleteProgram(shader_program_);
+    // Never initialized without a GL context (headless runs)
+    if (shader_program_) {
+        if (bound_program_g == shader_program_) {
+            bound_program_g = 0;
+        }
+        glDeleteProgram(shader_program_);
+    }
 }
 
 
 void Shader::Enable() 
 {
 
+    if (bound_program_g == shader_program_) {
+        return;
+    }
     glUseProgram(shader_program_);
+    bound_program_g = shader_program_;
+    RenderStats::CountShaderSwitch();
 }
 
 
@@ -162,6 +288,7 @@ void Shader::Disable()
 {
 
     glUseProgram(0);
+    bound_program_g = 0;
 }
 
 } // namespace game
@@ -4,9 +4,15 @@
 #define GLEW_STATIC
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <string>
+#include <vector>
 
 namespace game {
 
+    // Handle to a uniform of one Shader, returned by Shader::GetUniformId()
+    // Only valid for the shader that returned it
+    typedef int UniformId;
+
     // A class that stores a pair of vertex, fragment shaders
     class Shader {
 
@@ -18,28 +24,25 @@ namespace game {
             void Init(const char *vertPath, const char *fragPath);
 
             // Enable or disable this specific shader
+            // Enabling the program that is already bound does nothing
             void Enable();
             void Disable();
 
-            // Sets a uniform integer variable in your shader program to a value
-            void SetUniform1i(const GLchar *name, int value);
-
-            // Sets a uniform float variable in your shader program to a value
-            void SetUniform1f(const GLchar *name, float value);
-
-            // Sets a uniform vector2 variable in your shader program to a vector
-            void SetUniform2f(const GLchar *name, const glm::vec2 &vector);
-
-            // Sets a uniform vector3 variable in your shader program to a vector
-            void SetUniform3f(const GLchar *name, const glm::vec3 &vector);
+            // Look up a uniform once and return a handle for the setters below
+            // Unknown names return a valid handle whose sets are ignored
+            // Handles may be taken before Init(), they resolve on linking
+            UniformId GetUniformId(const GLchar *name);
 
-            // Sets a uniform vector4 variable in your shader program to a vector
-            void SetUniform4f(const GLchar *name, const glm::vec4 &vector);
+            // Handle-based setters, skip the upload if the value is unchanged
+            void SetUniform1i(UniformId id, int value);
+            void SetUniform1f(UniformId id, float value);
+            void SetUniform2f(UniformId id, const glm::vec2 &vector);
+            void SetUniform3f(UniformId id, const glm::vec3 &vector);
+            void SetUniform4f(UniformId id, const glm::vec4 &vector);
+            void SetUniformMat4(UniformId id, const glm::mat4 &matrix);
 
-            // Sets a uniform matrix4x4 variable in your shader program to a matrix4x4
-            void SetUniformMat4(const GLchar *name, const glm::mat4 &matrix);
-
-            void SetUniformIntArray(const GLchar* name, int len, const GLint* data);
+            // Uploads every time, arrays are not cached
+            void SetUniformIntArray(UniformId id, int len, const GLint* data);
 
 
             // Get OpenGL reference of shader program
@@ -49,6 +52,21 @@ namespace game {
             // Reference to shader program
             GLuint shader_program_;
 
+            // Cached location and last uploaded value of one uniform
+            struct UniformSlot {
+                std::string name;
+                GLint location;
+                bool has_value;        // False until the first upload
+                GLfloat value[16];     // Raw copy of the last upload (ints stored bitwise)
+            };
+            std::vector<UniformSlot> uniforms_;
+
+            // Fill the cache with every active uniform after linking
+            void CacheUniforms(void);
+
+            // Returns true if the value differs from the last upload, and records it
+            bool Changed(UniformSlot& slot, const void* data, size_t size);
+
     }; // class Shader
 } // namespace game
 
@@ -0,0 +1,381 @@
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <memory>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "sound_bank.h"
+#include "music_stream.h"
+
+namespace game {
+
+    namespace {
+
+        // Layout of a bank file, all integers little-endian:
+        //   header    magic "SFSB", version, clip count, reserved
+        //   index     one entry per clip, sorted by name
+        //   data      each clip's PCM, starting on a DATA_ALIGN boundary
+        const char bank_magic_g[4] = { 'S', 'F', 'S', 'B' };
+        const uint32_t bank_version_g = 1;
+        const size_t HEADER_SIZE = 16;
+        const size_t NAME_SIZE = 48;                    // Including the terminating zero
+        const size_t ENTRY_SIZE = NAME_SIZE + 16;       // Name, format, rate, offset, size
+        const size_t DATA_ALIGN = 16;
+
+        uint32_t ReadU32(const unsigned char* bytes) {
+            return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+                (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+        }
+
+        void WriteU32(std::vector<unsigned char>& out, uint32_t value) {
+            for (int i = 0; i < 4; i++) {
+                out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+            }
+        }
+
+        // Files in a directory, empty if it cannot be read
+        std::vector<std::string> ListDirectory(const std::string& directory) {
+            std::vector<std::string> names;
+#ifdef _WIN32
+            WIN32_FIND_DATAA found;
+            HANDLE search = FindFirstFileA((directory + "\\*").c_str(), &found);
+            if (search == INVALID_HANDLE_VALUE) {
+                return names;
+            }
+            do {
+                if (!(found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                    names.push_back(found.cFileName);
+                }
+            } while (FindNextFileA(search, &found));
+            FindClose(search);
+#else
+            DIR* dir = opendir(directory.c_str());
+            if (!dir) {
+                return names;
+            }
+            while (dirent* entry = readdir(dir)) {
+                if (entry->d_name[0] != '.') {
+                    names.push_back(entry->d_name);
+                }
+            }
+            closedir(dir);
+#endif
+            return names;
+        }
+
+        // Decode a whole file and mix it down to mono 16 bit PCM
+        bool DecodeMono(const std::string& path, std::vector<char>& pcm, ALsizei& sample_rate) {
+            std::unique_ptr<MusicDecoder> decoder(MusicDecoder::Open(path));
+            if (!decoder) {
+                return false;
+            }
+            sample_rate = decoder->GetSampleRate();
+            ALenum format = decoder->GetFormat();
+            bool stereo = format == AL_FORMAT_STEREO8 || format == AL_FORMAT_STEREO16;
+            bool wide = format == AL_FORMAT_MONO16 || format == AL_FORMAT_STEREO16;
+
+            std::vector<char> chunk;
+            std::vector<int16_t> samples;
+            while (decoder->Read(chunk, 65536)) {
+                size_t count = chunk.size() / (wide ? 2 : 1);
+                for (size_t i = 0; i < count; i++) {
+                    int sample;
+                    if (wide) {
+                        int16_t value;
+                        memcpy(&value, chunk.data() + 2 * i, 2);
+                        sample = value;
+                    }
+                    else {
+                        sample = (static_cast<unsigned char>(chunk[i]) - 128) << 8;
+                    }
+                    samples.push_back(static_cast<int16_t>(sample));
+                }
+            }
+
+            size_t frames = stereo ? samples.size() / 2 : samples.size();
+            pcm.resize(frames * sizeof(int16_t));
+            for (size_t i = 0; i < frames; i++) {
+                int16_t value = stereo ? static_cast<int16_t>((samples[2 * i] + samples[2 * i + 1]) / 2) : samples[i];
+                memcpy(pcm.data() + 2 * i, &value, 2);
+            }
+            return !pcm.empty();
+        }
+
+    } // namespace
+
+
+    SoundBank::SoundBank(void) : mapping_(nullptr), mapping_size_(0) {
+#ifdef _WIN32
+        file_ = INVALID_HANDLE_VALUE;
+        file_mapping_ = nullptr;
+#endif
+    }
+
+
+    SoundBank::~SoundBank() {
+        Close();
+    }
+
+
+    void SoundBank::Open(const std::string& path) {
+        Close();
+
+        // Map the whole file; the hint has the OS read it ahead in one go,
+        // as the index is followed by every clip in turn
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        LARGE_INTEGER size;
+        if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+            Close();
+            throw std::runtime_error("Failed to open sound bank: " + path);
+        }
+        file_mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (file_mapping_) {
+            mapping_ = static_cast<const unsigned char*>(MapViewOfFile(file_mapping_, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (!mapping_) {
+            Close();
+            throw std::runtime_error("Failed to map sound bank: " + path);
+        }
+        mapping_size_ = static_cast<size_t>(size.QuadPart);
+#else
+        int file = open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if (file < 0 || fstat(file, &info) != 0 || info.st_size == 0) {
+            if (file >= 0) {
+                close(file);
+            }
+            throw std::runtime_error("Failed to open sound bank: " + path);
+        }
+        void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Failed to map sound bank: " + path);
+        }
+        madvise(mapping, static_cast<size_t>(info.st_size), MADV_WILLNEED);
+        mapping_ = static_cast<const unsigned char*>(mapping);
+        mapping_size_ = static_cast<size_t>(info.st_size);
+#endif
+
+        if (mapping_size_ < HEADER_SIZE || memcmp(mapping_, bank_magic_g, 4) != 0 ||
+            ReadU32(mapping_ + 4) != bank_version_g) {
+            Close();
+            throw std::runtime_error("Not a sound bank: " + path);
+        }
+
+        uint32_t count = ReadU32(mapping_ + 8);
+        if (count > (mapping_size_ - HEADER_SIZE) / ENTRY_SIZE) {
+            Close();
+            throw std::runtime_error("Corrupt sound bank index: " + path);
+        }
+
+        clips_.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            const unsigned char* entry = mapping_ + HEADER_SIZE + i * ENTRY_SIZE;
+            const char* name = reinterpret_cast<const char*>(entry);
+            uint32_t offset = ReadU32(entry + NAME_SIZE + 8);
+            uint32_t size = ReadU32(entry + NAME_SIZE + 12);
+            if (name[NAME_SIZE - 1] != '\0' || offset > mapping_size_ || size > mapping_size_ - offset) {
+                Close();
+                throw std::runtime_error("Corrupt sound bank index: " + path);
+            }
+
+            Clip& clip = clips_[i];
+            clip.name = name;
+            clip.format = static_cast<ALenum>(ReadU32(entry + NAME_SIZE));
+            clip.sample_rate = static_cast<ALsizei>(ReadU32(entry + NAME_SIZE + 4));
+            clip.data = mapping_ + offset;
+            clip.size = static_cast<ALsizei>(size);
+        }
+    }
+
+
+    void SoundBank::Close(void) {
+        clips_.clear();
+#ifdef _WIN32
+        if (mapping_) {
+            UnmapViewOfFile(mapping_);
+        }
+        if (file_mapping_) {
+            CloseHandle(file_mapping_);
+            file_mapping_ = nullptr;
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (mapping_) {
+            munmap(const_cast<unsigned char*>(mapping_), mapping_size_);
+        }
+#endif
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+    }
+
+
+    const SoundBank::Clip* SoundBank::Find(const std::string& name) const {
+        std::string key = NormalizeName(name);
+        std::vector<Clip>::const_iterator found = std::lower_bound(clips_.begin(), clips_.end(), key,
+            [](const Clip& clip, const std::string& value) { return clip.name < value; });
+        if (found == clips_.end() || found->name != key) {
+            return nullptr;
+        }
+        return &(*found);
+    }
+
+
+    std::string SoundBank::NormalizeName(const std::string& name) {
+        size_t slash = name.find_last_of("/\\");
+        std::string normalized = slash == std::string::npos ? name : name.substr(slash + 1);
+        for (char& c : normalized) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return normalized;
+    }
+
+
+    bool SoundBank::Pack(const std::string& directory, const std::string& manifest, const std::string& output) {
+        std::ifstream list(manifest);
+        if (!list) {
+            std::cerr << "Cannot open sound manifest " << manifest << std::endl;
+            return false;
+        }
+
+        // What is really on disk, whatever case the manifest uses
+        std::map<std::string, std::string> files;
+        for (const std::string& file : ListDirectory(directory)) {
+            files[NormalizeName(file)] = file;
+        }
+
+        struct Packed {
+            std::string name;
+            ALsizei sample_rate;
+            std::vector<char> pcm;
+        };
+        std::vector<Packed> packed;
+        size_t music_tracks = 0;
+        bool music = false;
+        bool ok = true;
+
+        std::string line;
+        while (std::getline(list, line)) {
+            // One file per line, blank lines and # comments are skipped
+            line.erase(0, line.find_first_not_of(" \t\r"));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            if (line == "[music]") {
+                music = true;
+                continue;
+            }
+
+            // Streamed tracks stay in their own files, only check they play
+            if (music) {
+                std::map<std::string, std::string>::const_iterator file = files.find(NormalizeName(line));
+                if (file == files.end()) {
+                    std::cerr << "Missing music " << line << " in " << directory << std::endl;
+                    ok = false;
+                    continue;
+                }
+                if (file->second != line) {
+                    std::cerr << "Music " << line << " is named " << file->second << " on disk, the game opens it by its exact name" << std::endl;
+                    ok = false;
+                    continue;
+                }
+                std::unique_ptr<MusicDecoder> decoder(MusicDecoder::Open(directory + "/" + file->second));
+                if (!decoder) {
+                    std::cerr << "Cannot decode music " << file->second << ", only PCM and IMA ADPCM WAV files are supported" << std::endl;
+                    ok = false;
+                    continue;
+                }
+                music_tracks++;
+                continue;
+            }
+
+            Packed clip;
+            clip.name = NormalizeName(line);
+            std::map<std::string, std::string>::const_iterator file = files.find(clip.name);
+            if (file == files.end()) {
+                std::cerr << "Missing sound " << line << " in " << directory << std::endl;
+                ok = false;
+                continue;
+            }
+            if (clip.name.size() >= NAME_SIZE) {
+                std::cerr << "Sound name " << line << " is longer than " << NAME_SIZE - 1 << " characters" << std::endl;
+                ok = false;
+                continue;
+            }
+            if (file->second != line) {
+                std::cout << "Packing " << file->second << " for " << line << std::endl;
+            }
+            if (!DecodeMono(directory + "/" + file->second, clip.pcm, clip.sample_rate)) {
+                std::cerr << "Cannot decode sound " << file->second << ", only PCM and IMA ADPCM WAV files are supported" << std::endl;
+                ok = false;
+                continue;
+            }
+            packed.push_back(std::move(clip));
+        }
+        if (!ok) {
+            return false;
+        }
+
+        std::sort(packed.begin(), packed.end(), [](const Packed& a, const Packed& b) { return a.name < b.name; });
+        for (size_t i = 1; i < packed.size(); i++) {
+            if (packed[i].name == packed[i - 1].name) {
+                std::cerr << "Sound " << packed[i].name << " is listed twice" << std::endl;
+                return false;
+            }
+        }
+
+        // Header and index first, then the clips in index order
+        std::vector<unsigned char> bank(bank_magic_g, bank_magic_g + 4);
+        WriteU32(bank, bank_version_g);
+        WriteU32(bank, static_cast<uint32_t>(packed.size()));
+        WriteU32(bank, 0);
+
+        size_t offset = HEADER_SIZE + packed.size() * ENTRY_SIZE;
+        for (const Packed& clip : packed) {
+            offset = (offset + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+            std::vector<unsigned char> name(NAME_SIZE, 0);
+            memcpy(name.data(), clip.name.data(), clip.name.size());
+            bank.insert(bank.end(), name.begin(), name.end());
+            WriteU32(bank, static_cast<uint32_t>(AL_FORMAT_MONO16));
+            WriteU32(bank, static_cast<uint32_t>(clip.sample_rate));
+            WriteU32(bank, static_cast<uint32_t>(offset));
+            WriteU32(bank, static_cast<uint32_t>(clip.pcm.size()));
+            offset += clip.pcm.size();
+        }
+        for (const Packed& clip : packed) {
+            bank.resize((bank.size() + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN, 0);
+            bank.insert(bank.end(), clip.pcm.begin(), clip.pcm.end());
+        }
+
+        std::ofstream out(output, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bank.data()), bank.size());
+        if (!out) {
+            std::cerr << "Cannot write sound bank " << output << std::endl;
+            return false;
+        }
+        std::cout << "Packed " << packed.size() << " sounds into " << output << " (" << bank.size() << " bytes), checked " << music_tracks << " music tracks" << std::endl;
+        return true;
+    }
+
+} // namespace game
@@ -0,0 +1,73 @@
+#ifndef SOUND_BANK_H_
+#define SOUND_BANK_H_
+
+#include <AL/al.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace game {
+
+    // Every sound effect in one file, read with a single mapping at startup
+    // The file starts with a header and an index of clips, followed by each
+    // clip's PCM, ready for alBufferData. Clips are looked up by file name,
+    // without regard to case, so "RetroPickup10.wav" finds RetroPickUp10.wav
+    // Banks are built by Pack(), which the sound_bank_pack tool runs as part
+    // of the build
+    class SoundBank {
+
+    public:
+        // One clip in the mapped file
+        struct Clip {
+            std::string name;           // Normalized file name
+            ALenum format;
+            ALsizei sample_rate;
+            const void* data;
+            ALsizei size;
+        };
+
+        SoundBank(void);
+        ~SoundBank();
+
+        SoundBank(const SoundBank&) = delete;
+        SoundBank& operator=(const SoundBank&) = delete;
+
+        // Map a bank file and read its index, throws if it is not a bank
+        void Open(const std::string& path);
+
+        // Unmap the file, the clip data is gone afterwards
+        void Close(void);
+
+        // Clip for a file name, nullptr if the bank does not have it
+        const Clip* Find(const std::string& name) const;
+
+        inline const std::vector<Clip>& GetClips(void) const { return clips_; }
+
+        // Lower-case name without any directory, the key clips are stored under
+        static std::string NormalizeName(const std::string& name);
+
+        // Decode the files listed in a manifest, one name per line, from a
+        // directory and write them to a bank; clips are mixed down to mono
+        // so OpenAL can position them
+        // Names are matched against the directory without regard to case;
+        // every file that cannot be found or decoded is reported, and no
+        // bank is written if there are any
+        // Names after a "[music]" line are streamed tracks: they are not
+        // packed, only checked to exist under that exact name and to open
+        // with MusicDecoder
+        static bool Pack(const std::string& directory, const std::string& manifest, const std::string& output);
+
+    private:
+        std::vector<Clip> clips_;       // Sorted by name
+        const unsigned char* mapping_;
+        size_t mapping_size_;
+#ifdef _WIN32
+        void* file_;
+        void* file_mapping_;
+#endif
+
+    }; // class SoundBank
+
+} // namespace game
+
+#endif // SOUND_BANK_H_
@@ -0,0 +1,22 @@
+/*
+ * Sound bank packer for Strike Fighters
+ *
+ * Packs the sound effects listed in a manifest into the single file the game
+ * maps at startup. Music tracks listed in the manifest's [music] section are
+ * checked but not packed. Every listed file that is missing or cannot be
+ * decoded is reported, and the bank is only written if there are none
+ *
+ *   sound_bank_pack <audio directory> <manifest> <output bank>
+ */
+
+#include <iostream>
+
+#include "sound_bank.h"
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: sound_bank_pack <audio directory> <manifest> <output bank>" << std::endl;
+        return 2;
+    }
+    return game::SoundBank::Pack(argv[1], argv[2], argv[3]) ? 0 : 1;
+}
@@ -1,150 +1,132 @@
 #include "space_dust.h"
+#include "render_stats.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
-#include <ctime>
+
+#include "random.h"
 
 namespace game {
 
-    SpaceDust::SpaceDust(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture, int num_particles)
+    SpaceDust::SpaceDust(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture, int num_particles,
+        float bound_x, float bound_y)
         : GameObject(position, geom, shader, texture) {
 
-        // Initialize random number generator with current time
-        rng_ = std::mt19937(static_cast<unsigned int>(time(nullptr)));
+        // Blended behind everything already drawn
+        render_state_ = RenderState::Translucent();
+
+        // Seed from the effects stream so a replay looks the same too
+        rng_ = std::mt19937(Random::Next(RandomStream::EFFECTS));
 
-        // Set default boundaries
-        bound_x_ = 40.0f;
-        bound_y_ = 40.0f;
+        // Boundaries the field is generated in
+        bound_x_ = bound_x;
+        bound_y_ = bound_y;
 
         // Initialize distributions
-        dist_pos_ = std::uniform_real_distribution<float>(-bound_x_, bound_x_);
         dist_vel_ = std::uniform_real_distribution<float>(-0.5f, 0.5f);
         dist_size_ = std::uniform_real_distribution<float>(0.05f, 0.2f);
         dist_alpha_ = std::uniform_real_distribution<float>(0.3f, 0.8f);
 
         // Store number of particles
         num_particles_ = num_particles;
-
-        // Initialize particles
-        particles_.resize(num_particles_);
-        for (auto& particle : particles_) {
-            InitParticle(particle);
-        }
+        elapsed_ = 0.0;
+        center_id_ = shader->GetUniformId("center");
+        bounds_id_ = shader->GetUniformId("bounds");
+        time_id_ = shader->GetUniformId("time");
+
+        // The quad comes from the shared geometry, the particle attributes
+        // advance once per instance
+        glGenBuffers(1, &particle_vbo_);
+        glGenVertexArrays(1, &vao_);
+        glBindVertexArray(vao_);
+        geometry_->SetupAttributes();
+        glBindBuffer(GL_ARRAY_BUFFER, particle_vbo_);
+        glVertexAttribPointer(ATTRIB_INSTANCE_0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
+        glVertexAttribPointer(ATTRIB_INSTANCE_1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat),
+            (void*)(num_particles_ * 4 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(ATTRIB_INSTANCE_0);
+        glEnableVertexAttribArray(ATTRIB_INSTANCE_1);
+        glVertexAttribDivisor(ATTRIB_INSTANCE_0, 1);
+        glVertexAttribDivisor(ATTRIB_INSTANCE_1, 1);
+        glBindVertexArray(0);
+
+        GenerateParticles();
     }
 
     SpaceDust::~SpaceDust() {
-        // Nothing to clean up as vector handles memory management
+        glDeleteVertexArrays(1, &vao_);
+        glDeleteBuffers(1, &particle_vbo_);
     }
 
-    void SpaceDust::InitParticle(DustParticle& particle, bool randomize_pos) {
-        if (randomize_pos) {
+    void SpaceDust::GenerateParticles(void) {
+        std::uniform_real_distribution<float> dist_x(-bound_x_, bound_x_);
+        std::uniform_real_distribution<float> dist_y(-bound_y_, bound_y_);
+
+        std::vector<GLfloat> data(num_particles_ * 6);
+        GLfloat* motion = &data[0];
+        GLfloat* look = &data[num_particles_ * 4];
+        for (int i = 0; i < num_particles_; i++) {
             // Random position within bounds
-            particle.position = glm::vec3(dist_pos_(rng_), dist_pos_(rng_), 0.0f);
-        }
+            motion[i * 4 + 0] = dist_x(rng_);
+            motion[i * 4 + 1] = dist_y(rng_);
+
+            // Random velocity, very slow for dust-like effect
+            motion[i * 4 + 2] = dist_vel_(rng_);
+            motion[i * 4 + 3] = dist_vel_(rng_);
 
-        // Random velocity, very slow for dust-like effect
-        particle.velocity = glm::vec3(dist_vel_(rng_), dist_vel_(rng_), 0.0f);
+            // Random size for variety, random alpha for depth illusion
+            look[i * 2 + 0] = dist_size_(rng_);
+            look[i * 2 + 1] = dist_alpha_(rng_);
+        }
 
-        // Random size for variety
-        particle.size = dist_size_(rng_);
+        glBindBuffer(GL_ARRAY_BUFFER, particle_vbo_);
+        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(GLfloat), data.data(), GL_STATIC_DRAW);
 
-        // Random alpha for depth illusion
-        particle.alpha = dist_alpha_(rng_);
+        // Restart the drift so the new field starts from its generated positions
+        elapsed_ = 0.0;
     }
 
     void SpaceDust::Update(double delta_time) {
-        // Update position of each particle
-        for (auto& particle : particles_) {
-            // Move based on velocity
-            particle.position += particle.velocity * static_cast<float>(delta_time);
-
-            // Check if particle is out of bounds
-            if (abs(particle.position.x) > bound_x_ || abs(particle.position.y) > bound_y_) {
-                // Reset particle but at opposite edge for seamless effect
-                float edge_x = particle.position.x > 0 ? -bound_x_ : bound_x_;
-                float edge_y = particle.position.y > 0 ? -bound_y_ : bound_y_;
-
-                // If moving horizontally out of bounds
-                if (abs(particle.position.x) > bound_x_) {
-                    particle.position.x = edge_x;
-                    particle.position.y = dist_pos_(rng_); // Random y position
-                }
-                // If moving vertically out of bounds
-                else {
-                    particle.position.x = dist_pos_(rng_); // Random x position
-                    particle.position.y = edge_y;
-                }
-
-                // Randomize other properties for variety
-                InitParticle(particle, false);
-            }
-        }
+        // Particles move in the vertex shader, only the clock advances here
+        elapsed_ += delta_time;
 
         // Call parent's update
         GameObject::Update(delta_time);
     }
 
     void SpaceDust::Render(glm::mat4 view_matrix, double current_time) {
-        // Enable blending for transparent particles
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-        // Disable depth testing for particles
-        glDisable(GL_DEPTH_TEST);
+        RenderPassScope pass(RenderPass::SPACE_DUST);
 
-        // Setup shader
+        // Setup shader and blending
         shader_->Enable();
+        render_state_.Apply();
 
-        // Set view matrix
-        shader_->SetUniformMat4("view_matrix", view_matrix);
+        // Set view matrix and the field's placement
+        shader_->SetUniformMat4(view_matrix_id_, view_matrix);
+        shader_->SetUniform2f(center_id_, glm::vec2(position_.x, position_.y));
+        shader_->SetUniform2f(bounds_id_, glm::vec2(bound_x_, bound_y_));
 
-        // Set time uniform for possible animation effects
-        shader_->SetUniform1f("time", static_cast<float>(current_time));
+        // Drift time, also drives the shimmer in the fragment shader
+        shader_->SetUniform1f(time_id_, static_cast<float>(elapsed_));
 
         // Bind texture
         glBindTexture(GL_TEXTURE_2D, texture_);
+        RenderStats::CountTextureBind();
 
-        // Render each particle
-        for (const auto& particle : particles_) {
-            // Calculate transformation for this particle
-            glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f),
-                glm::vec3(particle.size, particle.size, 1.0f));
-            glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f),
-                particle.position);
-            glm::mat4 transform = translation_matrix * scaling_matrix;
-
-            // Set transformation matrix
-            shader_->SetUniformMat4("transformation_matrix", transform);
-
-            // Set particle alpha - add to shader if needed
-            if (shader_->GetShaderProgram() != 0) {
-                // Try to set alpha if the shader supports it
-                try {
-                    shader_->SetUniform1f("alpha", particle.alpha);
-                }
-                catch (...) {
-                    // Ignore if uniform doesn't exist
-                }
-            }
-
-            // Set geometry
-            geometry_->SetGeometry(shader_->GetShaderProgram());
-
-            // Draw the particle
-            glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
-        }
+        // Draw the whole field at once
+        glBindVertexArray(vao_);
+        glDrawElementsInstanced(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0, num_particles_);
+        RenderStats::CountDraw();
 
         // Cleanup
         shader_->Disable();
-        glEnable(GL_DEPTH_TEST);
-        glDisable(GL_BLEND);
     }
 
     void SpaceDust::SetBounds(float bound_x, float bound_y) {
         bound_x_ = bound_x;
         bound_y_ = bound_y;
 
-        // Update distribution ranges
-        dist_pos_ = std::uniform_real_distribution<float>(-bound_x_, bound_x_);
+        // Spread the field over the new area
+        GenerateParticles();
     }
 
-} // namespace game
\ No newline at end of file
+} // namespace game
@@ -7,46 +7,58 @@
 
 namespace game {
 
-    // Structure to hold data for a single dust particle
-    struct DustParticle {
-        glm::vec3 position;
-        glm::vec3 velocity;
-        float size;
-        float alpha;
-    };
-
-    // A class for simulating space dust particles
+    // A field of space dust drawn with a single instanced call
+    // Particle state lives in a vertex buffer written once; drift and the
+    // wraparound at the bounds are computed in the vertex shader from the
+    // elapsed time, so the CPU does no per-particle work after setup
     class SpaceDust : public GameObject {
     public:
-        // Constructor
-        SpaceDust(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture, int num_particles = 200);
+        // Constructor, needs a GL context (creates and fills the particle
+        // buffer, with particles spread over +-bound_x by +-bound_y)
+        SpaceDust(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture, int num_particles = 200,
+            float bound_x = 40.0f, float bound_y = 40.0f);
 
         // Destructor
         ~SpaceDust();
 
-        // Update the position of particles
+        // Advance the field's clock
         void Update(double delta_time) override;
 
         // Render the particles
         void Render(glm::mat4 view_matrix, double current_time) override;
+        // Particles use their own shader
+        bool Submit(SpriteBatch& batch) override { return false; }
 
-        // Set the boundary for particles
+        // Change the boundary for particles (regenerates the field, so pass
+        // the bounds to the constructor when they are known up front)
         void SetBounds(float bound_x, float bound_y);
 
     private:
-        // Initialize a dust particle
-        void InitParticle(DustParticle& particle, bool randomize_pos = true);
+        // Fill the particle buffer with a new random field
+        void GenerateParticles(void);
 
-        std::vector<DustParticle> particles_;
         int num_particles_;
 
+        // Particle buffer, structure of arrays:
+        // num_particles_ vec4 (start x, start y, velocity x, velocity y)
+        // followed by num_particles_ vec2 (size, alpha)
+        GLuint particle_vbo_;
+        GLuint vao_;
+
+        // Time the particles have been drifting
+        double elapsed_;
+
+        // Uniforms of the dust shader
+        UniformId center_id_;
+        UniformId bounds_id_;
+        UniformId time_id_;
+
         // Boundaries for particles
         float bound_x_;
         float bound_y_;
 
         // Random number generator
         std::mt19937 rng_;
-        std::uniform_real_distribution<float> dist_pos_;
         std::uniform_real_distribution<float> dist_vel_;
         std::uniform_real_distribution<float> dist_size_;
         std::uniform_real_distribution<float> dist_alpha_;
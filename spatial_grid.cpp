@@ -0,0 +1,44 @@
+#include <cmath>
+
+#include "spatial_grid.h"
+
+namespace game {
+
+    SpatialGrid::SpatialGrid(float bound, float cell_size, float slack)
+        : bound_(bound), cell_size_(cell_size), slack_(slack), max_radius_(0.0f) {
+        cells_per_side_ = std::max(1, static_cast<int>(std::ceil(2.0f * bound / cell_size)));
+        cell_start_.assign(cells_per_side_ * cells_per_side_ + 1, 0);
+    }
+
+    void SpatialGrid::Clear(void) {
+        pending_.clear();
+        pending_cells_.clear();
+        entries_.clear();
+        std::fill(cell_start_.begin(), cell_start_.end(), 0);
+        max_radius_ = 0.0f;
+    }
+
+    void SpatialGrid::Insert(EntityHandle handle, const glm::vec3& position, float radius, int part) {
+        pending_.push_back({ handle, part, position, radius });
+        pending_cells_.push_back(CellIndex(position));
+        max_radius_ = std::max(max_radius_, radius);
+    }
+
+    void SpatialGrid::Build(void) {
+        // Counting sort: count per cell, prefix sum, then scatter
+        std::fill(cell_start_.begin(), cell_start_.end(), 0);
+        for (int cell : pending_cells_) {
+            cell_start_[cell + 1]++;
+        }
+        for (size_t i = 1; i < cell_start_.size(); i++) {
+            cell_start_[i] += cell_start_[i - 1];
+        }
+
+        entries_.resize(pending_.size());
+        cell_next_.assign(cell_start_.begin(), cell_start_.end() - 1);
+        for (size_t i = 0; i < pending_.size(); i++) {
+            entries_[cell_next_[pending_cells_[i]]++] = pending_[i];
+        }
+    }
+
+} // namespace game
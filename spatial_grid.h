@@ -0,0 +1,156 @@
+#ifndef SPATIAL_GRID_H_
+#define SPATIAL_GRID_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <algorithm>
+
+#include "entity_handle.h"
+
+namespace game {
+
+    // Uniform grid over the square play area, used as the collision broadphase
+    // Entries are bucketed by their center only, so every query is widened by
+    // the largest radius inserted since the last Clear()
+    // Positions outside the bounds are clamped into the border cells
+    class SpatialGrid {
+    public:
+        struct Entry {
+            EntityHandle handle;   // Entity the entry belongs to
+            int part;              // Sub-part of the entity (boss arms), 0 otherwise
+            glm::vec3 position;    // Center at build time
+            float radius;          // Collision radius
+        };
+
+        // bound: half size of the covered area, cell_size: side of one cell
+        // slack: extra query margin for objects that move after the build
+        SpatialGrid(float bound, float cell_size, float slack);
+
+        // Drop all entries
+        void Clear(void);
+
+        // Queue an entry, it becomes visible to queries after Build()
+        void Insert(EntityHandle handle, const glm::vec3& position, float radius, int part = 0);
+
+        // Sort the queued entries into their cells
+        void Build(void);
+
+        // Call fn(const Entry&) for every entry in the cells overlapping the circle
+        // Stops early if fn returns false
+        // Entries are only candidates, the caller does the exact test
+        template <typename Fn>
+        void QueryCircle(const glm::vec3& center, float radius, Fn fn) const {
+            QueryBox(center - glm::vec3(radius), center + glm::vec3(radius), fn);
+        }
+
+        // Same as QueryCircle, for a swept segment (origin + t * direction, t in [0, length])
+        template <typename Fn>
+        void QuerySegment(const glm::vec3& origin, const glm::vec3& direction, float length, Fn fn) const {
+            glm::vec3 end = origin + direction * length;
+            QueryBox(glm::min(origin, end), glm::max(origin, end), fn);
+        }
+
+        // The entry with the lowest cost(const Entry&) whose center lies within
+        // max_distance of center, or nullptr if there is none
+        // cost returns a negative value to reject an entry, and must never be
+        // less than the entry's distance from center: cells are visited in
+        // rings of growing distance and the search stops at the first ring
+        // that cannot hold a cheaper entry, so a nearby hit costs a few cells
+        // however many entries the grid holds
+        template <typename CostFn>
+        const Entry* FindBest(const glm::vec3& center, float max_distance, CostFn cost) const {
+            if (entries_.empty()) {
+                return nullptr;
+            }
+            const Entry* best = nullptr;
+            float best_cost = 0.0f;
+            int cx = CellCoord(center.x);
+            int cy = CellCoord(center.y);
+            int last = cells_per_side_ - 1;
+            for (int r = 0; ; r++) {
+                // Any center in ring r is at least this far, the query
+                // point can sit anywhere in its own cell
+                float ring_distance = std::max(r - 1, 0) * cell_size_;
+                if (ring_distance > max_distance || (best && ring_distance >= best_cost)) {
+                    break;
+                }
+                if (cx - r < 0 && cy - r < 0 && cx + r > last && cy + r > last) {
+                    break;
+                }
+                for (int y = std::max(cy - r, 0); y <= std::min(cy + r, last); y++) {
+                    // Full rows at the top and bottom of the ring, its two ends otherwise
+                    bool full_row = (y == cy - r || y == cy + r);
+                    int step = full_row ? 1 : std::max(2 * r, 1);
+                    for (int x = cx - r; x <= cx + r; x += step) {
+                        if (x < 0 || x > last) {
+                            continue;
+                        }
+                        int cell = y * cells_per_side_ + x;
+                        for (int i = cell_start_[cell]; i < cell_start_[cell + 1]; i++) {
+                            const Entry& entry = entries_[i];
+                            if (glm::length(entry.position - center) > max_distance) {
+                                continue;
+                            }
+                            float c = cost(entry);
+                            if (c >= 0.0f && (!best || c < best_cost)) {
+                                best = &entry;
+                                best_cost = c;
+                            }
+                        }
+                    }
+                }
+            }
+            return best;
+        }
+
+        inline size_t Size(void) const { return entries_.size(); }
+
+    private:
+        template <typename Fn>
+        void QueryBox(const glm::vec3& box_min, const glm::vec3& box_max, Fn fn) const {
+            if (entries_.empty()) {
+                return;
+            }
+            float margin = max_radius_ + slack_;
+            int x0 = CellCoord(box_min.x - margin);
+            int x1 = CellCoord(box_max.x + margin);
+            int y0 = CellCoord(box_min.y - margin);
+            int y1 = CellCoord(box_max.y + margin);
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) {
+                    int cell = y * cells_per_side_ + x;
+                    for (int i = cell_start_[cell]; i < cell_start_[cell + 1]; i++) {
+                        if (!fn(entries_[i])) {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+
+        inline int CellCoord(float v) const {
+            int c = static_cast<int>((v + bound_) / cell_size_);
+            return std::min(std::max(c, 0), cells_per_side_ - 1);
+        }
+
+        inline int CellIndex(const glm::vec3& p) const {
+            return CellCoord(p.y) * cells_per_side_ + CellCoord(p.x);
+        }
+
+        float bound_;
+        float cell_size_;
+        float slack_;
+        int cells_per_side_;
+        float max_radius_;
+
+        std::vector<Entry> pending_;      // Entries queued since Clear()
+        std::vector<int> pending_cells_;  // Cell of each queued entry
+        std::vector<Entry> entries_;      // Entries sorted by cell
+        std::vector<int> cell_start_;     // First entry of each cell, plus an end marker
+        std::vector<int> cell_next_;      // Scatter cursor per cell, reused by Build()
+
+    }; // class SpatialGrid
+
+} // namespace game
+
+#endif // SPATIAL_GRID_H_
@@ -38,6 +38,9 @@ void Sprite::CreateGeometry(void){
         2, 3, 0  // t2
     };
 
+    // The index buffer binding below would land in whatever vertex array is bound
+    glBindVertexArray(0);
+
     // Create buffer for vertices
     glGenBuffers(1, &vbo_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
@@ -50,34 +53,29 @@ void Sprite::CreateGeometry(void){
 
     // Set number of elements in array buffer (6 in this case)
     size_ = sizeof(face) / sizeof(GLuint);
+
+    // Record the attribute layout once
+    CreateVertexArray();
 }
 
 
-void Sprite::SetGeometry(GLuint shader_program)
+void Sprite::SetupAttributes(void)
 {
 
-    // No blending
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDisable(GL_BLEND);
-
     // Bind buffers
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
 
     // Set attributes for shaders
     // Should be consistent with how we created the buffers for the square
-    GLint vertex_att = glGetAttribLocation(shader_program, "vertex");
-    glVertexAttribPointer(vertex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
-    glEnableVertexAttribArray(vertex_att);
+    glVertexAttribPointer(ATTRIB_VERTEX, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
+    glEnableVertexAttribArray(ATTRIB_VERTEX);
 
-    GLint color_att = glGetAttribLocation(shader_program, "color");
-    glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(2 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(color_att);
+    glVertexAttribPointer(ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(2 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(ATTRIB_COLOR);
 
-    GLint tex_att = glGetAttribLocation(shader_program, "uv");
-    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(5 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(tex_att);
+    glVertexAttribPointer(ATTRIB_UV, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(5 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(ATTRIB_UV);
 }
 
 } // namespace game
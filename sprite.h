@@ -15,8 +15,8 @@ namespace game {
             // Create the geometry (called once)
             void CreateGeometry(void);
 
-            // Use the geometry
-            void SetGeometry(GLuint shader_program);
+            // Describe the quad's attributes into the bound vertex array object
+            void SetupAttributes(void);
 
     }; // class Sprite
 } // namespace game
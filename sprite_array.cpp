@@ -0,0 +1,102 @@
+#include <cstring>
+
+#include "sprite_array.h"
+
+namespace game {
+
+    SpriteArray::SpriteArray(void) : layer_count_(0), texture_(0) {
+    }
+
+
+    SpriteArray::~SpriteArray() {
+    }
+
+
+    void SpriteArray::Reserve(GLuint texture) {
+        if (GetLayer(texture) >= 0) {
+            return;
+        }
+        if (texture >= layers_.size()) {
+            Layer unpacked = { -1, glm::vec2(1.0f) };
+            layers_.resize(texture + 1, unpacked);
+        }
+        layers_[texture].layer = layer_count_++;
+    }
+
+
+    void SpriteArray::Init(void) {
+        if (layer_count_ == 0) {
+            return;
+        }
+
+        // Transparent until the images arrive
+        std::vector<unsigned char> clear(static_cast<size_t>(LAYER_SIZE) * LAYER_SIZE * 4 * layer_count_, 0);
+
+        glGenTextures(1, &texture_);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture_);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, LAYER_SIZE, LAYER_SIZE, layer_count_, 0,
+            GL_RGBA, GL_UNSIGNED_BYTE, clear.data());
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    }
+
+
+    bool SpriteArray::SetImage(GLuint texture, const unsigned char* rgba, int width, int height) {
+        int layer = GetLayer(texture);
+        if (layer < 0 || !texture_) {
+            return false;
+        }
+        if (width <= 0 || height <= 0 || width > LAYER_SIZE || height > LAYER_SIZE) {
+            // Left out of the array, the texture is drawn on its own instead
+            layers_[texture].layer = -1;
+            return false;
+        }
+
+        // Extend the image over the whole layer by repeating its edges
+        const size_t row_bytes = static_cast<size_t>(LAYER_SIZE) * 4;
+        std::vector<unsigned char> extruded(row_bytes * LAYER_SIZE);
+        for (int y = 0; y < height; y++) {
+            unsigned char* row = &extruded[y * row_bytes];
+            std::memcpy(row, rgba + static_cast<size_t>(y) * width * 4, static_cast<size_t>(width) * 4);
+            const unsigned char* edge = row + (width - 1) * 4;
+            for (int x = width; x < LAYER_SIZE; x++) {
+                std::memcpy(row + x * 4, edge, 4);
+            }
+        }
+        for (int y = height; y < LAYER_SIZE; y++) {
+            std::memcpy(&extruded[y * row_bytes], &extruded[(height - 1) * row_bytes], row_bytes);
+        }
+
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture_);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, LAYER_SIZE, LAYER_SIZE, 1,
+            GL_RGBA, GL_UNSIGNED_BYTE, extruded.data());
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        layers_[texture].uv_scale = glm::vec2(static_cast<float>(width) / LAYER_SIZE,
+            static_cast<float>(height) / LAYER_SIZE);
+        return true;
+    }
+
+
+    void SpriteArray::GenerateMipmaps(void) {
+        if (!texture_) {
+            return;
+        }
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture_);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    }
+
+
+    void SpriteArray::Release(void) {
+        if (texture_) {
+            glDeleteTextures(1, &texture_);
+            texture_ = 0;
+        }
+    }
+
+} // namespace game
@@ -0,0 +1,70 @@
+#ifndef SPRITE_ARRAY_H_
+#define SPRITE_ARRAY_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace game {
+
+    // Sprite images packed into the layers of one GL_TEXTURE_2D_ARRAY, so
+    // sprites with different images can share a draw call and a bind
+    // Every layer is LAYER_SIZE square; an image sits in the corner of its
+    // layer and is addressed with a UV scale, so nothing is resampled
+    // The image's last row and column are repeated over the rest of the
+    // layer, so filtering and mipmaps near its edges see the same texels
+    // clamping would, not the padding
+    // Textures are looked up by the name of their ordinary 2D texture, which
+    // stays valid for everything drawn outside the batch
+    class SpriteArray {
+
+    public:
+        static const int LAYER_SIZE = 256;
+
+        SpriteArray(void);
+        ~SpriteArray();
+
+        // Give a 2D texture a layer, call before Init()
+        void Reserve(GLuint texture);
+
+        // Allocate a transparent layer for every reserved texture, call once
+        // the GL context exists
+        void Init(void);
+
+        // Copy a texture's image into its layer, returns false if the
+        // texture has no layer or the image does not fit, in which case the
+        // texture is unpacked again
+        bool SetImage(GLuint texture, const unsigned char* rgba, int width, int height);
+
+        // Build the mipmaps once every image is in
+        void GenerateMipmaps(void);
+
+        // Layer of a texture and the UV scale of its image, layer is -1 if
+        // the texture is not packed
+        inline int GetLayer(GLuint texture) const {
+            return texture < layers_.size() ? layers_[texture].layer : -1;
+        }
+        inline glm::vec2 GetUVScale(GLuint texture) const { return layers_[texture].uv_scale; }
+
+        inline GLuint GetTexture(void) const { return texture_; }
+        inline int GetLayerCount(void) const { return layer_count_; }
+
+        // Delete the array texture, call while the GL context still exists
+        void Release(void);
+
+    private:
+        struct Layer {
+            int layer;
+            glm::vec2 uv_scale;
+        };
+
+        std::vector<Layer> layers_;   // Indexed by 2D texture name
+        int layer_count_;
+        GLuint texture_;
+
+    }; // class SpriteArray
+
+} // namespace game
+
+#endif // SPRITE_ARRAY_H_
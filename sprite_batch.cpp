@@ -0,0 +1,154 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "sprite_batch.h"
+#include "render_stats.h"
+
+namespace game {
+
+    SpriteBatch::SpriteBatch(void) {
+        geometry_ = nullptr;
+        shader_ = nullptr;
+        sprites_ = nullptr;
+        vao_ = 0;
+        instance_vbo_ = 0;
+        instance_capacity_ = 0;
+        view_matrix_ = glm::mat4(1.0f);
+        pending_ = 0;
+        draw_count_ = 0;
+    }
+
+
+    SpriteBatch::~SpriteBatch() {
+        if (instance_vbo_) {
+            glDeleteBuffers(1, &instance_vbo_);
+        }
+        if (vao_) {
+            glDeleteVertexArrays(1, &vao_);
+        }
+    }
+
+
+    void SpriteBatch::Init(Geometry* geom, Shader* shader, const SpriteArray* sprites) {
+        if (!geom || !shader || !sprites) {
+            throw std::runtime_error("Invalid geometry, shader or sprite array in SpriteBatch::Init");
+        }
+        geometry_ = geom;
+        shader_ = shader;
+        view_matrix_id_ = shader->GetUniformId("view_matrix");
+        sprites_ = sprites;
+        glGenBuffers(1, &instance_vbo_);
+
+        // The quad attributes come from the geometry, the instance attributes
+        // advance once per sprite
+        glGenVertexArrays(1, &vao_);
+        glBindVertexArray(vao_);
+        geometry_->SetupAttributes();
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+        glEnableVertexAttribArray(ATTRIB_INSTANCE_0);
+        glEnableVertexAttribArray(ATTRIB_INSTANCE_1);
+        glEnableVertexAttribArray(ATTRIB_INSTANCE_2);
+        glVertexAttribDivisor(ATTRIB_INSTANCE_0, 1);
+        glVertexAttribDivisor(ATTRIB_INSTANCE_1, 1);
+        glVertexAttribDivisor(ATTRIB_INSTANCE_2, 1);
+        SetInstanceOffset(0);
+        glBindVertexArray(0);
+    }
+
+
+    void SpriteBatch::SetInstanceOffset(size_t first) {
+        const char* offset = reinterpret_cast<const char*>(first * sizeof(Instance));
+        glVertexAttribPointer(ATTRIB_INSTANCE_0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), offset);
+        glVertexAttribPointer(ATTRIB_INSTANCE_1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), offset + sizeof(glm::vec4));
+        glVertexAttribPointer(ATTRIB_INSTANCE_2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), offset + 2 * sizeof(glm::vec4));
+    }
+
+
+    void SpriteBatch::Begin(const glm::mat4& view_matrix) {
+        view_matrix_ = view_matrix;
+        draw_count_ = 0;
+        for (Bucket& bucket : buckets_) {
+            bucket.instances.clear();
+        }
+        pending_ = 0;
+    }
+
+
+    bool SpriteBatch::Add(const RenderState& state, GLuint texture, const glm::vec3& position, const glm::vec2& scale, float angle, bool ghost) {
+        int layer = sprites_ ? sprites_->GetLayer(texture) : -1;
+        if (layer < 0) {
+            return false;
+        }
+
+        // Buckets stay sorted by state so a flush changes state as little as possible
+        auto less = [](const Bucket& b, uint32_t key) {
+            return b.state.GetKey() < key;
+        };
+        auto it = std::lower_bound(buckets_.begin(), buckets_.end(), state.GetKey(), less);
+        if (it == buckets_.end() || it->state != state) {
+            it = buckets_.insert(it, { state, std::vector<Instance>() });
+        }
+        Bucket* bucket = &(*it);
+
+        Instance instance;
+        instance.position_angle = glm::vec4(position.x, position.y, position.z, angle);
+        instance.scale_ghost = glm::vec4(scale.x, scale.y, ghost ? 1.0f : 0.0f, 0.0f);
+        glm::vec2 uv_scale = sprites_->GetUVScale(texture);
+        instance.uv_layer = glm::vec4(uv_scale.x, uv_scale.y, static_cast<float>(layer), 0.0f);
+        bucket->instances.push_back(instance);
+        pending_++;
+        return true;
+    }
+
+
+    void SpriteBatch::Flush(void) {
+        if (pending_ == 0 || !shader_) {
+            return;
+        }
+
+        // Pack every bucket into one upload, remembering where each starts
+        upload_.clear();
+        for (const Bucket& bucket : buckets_) {
+            upload_.insert(upload_.end(), bucket.instances.begin(), bucket.instances.end());
+        }
+
+        shader_->Enable();
+        shader_->SetUniformMat4(view_matrix_id_, view_matrix_);
+        glBindVertexArray(vao_);
+
+        // Every sprite samples the one array
+        glBindTexture(GL_TEXTURE_2D_ARRAY, sprites_->GetTexture());
+        RenderStats::CountTextureBind();
+
+        // Orphan and refill the instance buffer
+        GLsizeiptr bytes = static_cast<GLsizeiptr>(upload_.size() * sizeof(Instance));
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_);
+        if (bytes > instance_capacity_) {
+            instance_capacity_ = bytes * 2;
+        }
+        glBufferData(GL_ARRAY_BUFFER, instance_capacity_, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, upload_.data());
+
+        size_t first = 0;
+        for (Bucket& bucket : buckets_) {
+            if (bucket.instances.empty()) {
+                continue;
+            }
+
+            // Point the instance attributes at this bucket's slice of the buffer
+            SetInstanceOffset(first);
+
+            bucket.state.Apply();
+            glDrawElementsInstanced(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0,
+                static_cast<GLsizei>(bucket.instances.size()));
+            RenderStats::CountDraw();
+            draw_count_++;
+
+            first += bucket.instances.size();
+            bucket.instances.clear();
+        }
+
+        pending_ = 0;
+    }
+
+} // namespace game
@@ -0,0 +1,80 @@
+#ifndef SPRITE_BATCH_H_
+#define SPRITE_BATCH_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "shader.h"
+#include "geometry.h"
+#include "render_state.h"
+#include "sprite_array.h"
+
+namespace game {
+
+    // Collects plain textured sprites over a frame and draws them with one
+    // instanced call per render state, reusing the shared sprite quad
+    // Sprites sample their image from the layers of a SpriteArray, so sprites
+    // with different textures share a call; sprites sharing a state are drawn
+    // in the order they were added
+    class SpriteBatch {
+
+    public:
+        SpriteBatch(void);
+        ~SpriteBatch();
+
+        // Create the instance buffer, call once the GL context exists
+        // geom is the sprite quad, shader is the instanced sprite shader and
+        // sprites holds the images the batch can draw
+        void Init(Geometry* geom, Shader* shader, const SpriteArray* sprites);
+
+        // Start a new frame of sprites
+        void Begin(const glm::mat4& view_matrix);
+
+        // Queue one sprite, returns false if its texture is not in the
+        // sprite array and it has to be drawn some other way
+        bool Add(const RenderState& state, GLuint texture, const glm::vec3& position, const glm::vec2& scale, float angle, bool ghost);
+
+        // Draw everything queued since the last flush
+        void Flush(void);
+
+        // Instanced draw calls issued since Begin()
+        inline int GetDrawCount(void) const { return draw_count_; }
+
+    private:
+        // Per-instance data, must match the instance attributes of the shader
+        struct Instance {
+            glm::vec4 position_angle;  // xyz position, w rotation angle
+            glm::vec4 scale_ghost;     // xy scale, z ghost flag, w unused
+            glm::vec4 uv_layer;        // xy UV scale, z array layer, w unused
+        };
+
+        // Sprites queued for one render state
+        struct Bucket {
+            RenderState state;
+            std::vector<Instance> instances;
+        };
+
+        // Point the instance attributes at the instance buffer, starting at an instance
+        void SetInstanceOffset(size_t first);
+
+        Geometry* geometry_;
+        Shader* shader_;
+        UniformId view_matrix_id_;
+        const SpriteArray* sprites_;
+        GLuint vao_;                    // Quad attributes plus instance attributes
+        GLuint instance_vbo_;
+        GLsizeiptr instance_capacity_;  // Size of the instance buffer in bytes
+
+        glm::mat4 view_matrix_;
+        std::vector<Bucket> buckets_;   // Sorted by state, kept across frames
+        std::vector<Instance> upload_;  // Staging copy of all buckets
+        int pending_;                   // Sprites queued since the last flush
+        int draw_count_;
+
+    }; // class SpriteBatch
+
+} // namespace game
+
+#endif // SPRITE_BATCH_H_
@@ -0,0 +1,29 @@
+// Source code of the instanced sprite fragment shader
+#version 130
+// Attributes passed from the vertex shader
+in vec4 color_interp;
+in vec3 uv_interp;
+flat in int ghost_interp;
+// Sprite array sampler, uv_interp.z picks the layer
+uniform sampler2DArray onetex;
+
+void main()
+{
+    // Sample texture
+    vec4 color = texture(onetex, uv_interp);
+
+    // Apply ghost mode (grayscale) if enabled
+    if (ghost_interp == 1) {
+        // Convert to grayscale using luminance formula
+        float luminance = 0.299 * color.r + 0.587 * color.g + 0.114 * color.b;
+        color = vec4(luminance, luminance, luminance, color.a);
+    }
+
+    // Assign color to fragment
+    gl_FragColor = color;
+
+    // Check for transparency
+    if (color.a < 1.0) {
+        discard;
+    }
+}
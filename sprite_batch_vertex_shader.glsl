@@ -0,0 +1,37 @@
+// Source code of the instanced sprite vertex shader
+#version 130
+
+// Vertex buffer (shared sprite quad)
+in vec2 vertex;
+in vec3 color;
+in vec2 uv;
+
+// Instance buffer, one entry per sprite
+in vec4 instance_position_angle;  // xyz position, w rotation angle
+in vec4 instance_scale_ghost;     // xy scale, z ghost flag
+in vec4 instance_uv_layer;        // xy UV scale, z sprite array layer
+
+// Uniform (global) buffer
+uniform mat4 view_matrix;
+
+// Attributes forwarded to the fragment shader
+out vec4 color_interp;
+out vec3 uv_interp;
+flat out int ghost_interp;
+
+void main()
+{
+    // Scale, rotate, then translate the quad, same as GameObject::Render
+    vec2 scaled = vertex * instance_scale_ghost.xy;
+    float c = cos(instance_position_angle.w);
+    float s = sin(instance_position_angle.w);
+    vec2 rotated = vec2(c * scaled.x - s * scaled.y, s * scaled.x + c * scaled.y);
+    vec4 vertex_pos = vec4(rotated + instance_position_angle.xy, instance_position_angle.z, 1.0);
+    gl_Position = view_matrix * vertex_pos;
+
+    // Pass attributes to fragment shader
+    color_interp = vec4(color, 1.0);
+    // The image fills the corner of its layer
+    uv_interp = vec3(uv * instance_uv_layer.xy, instance_uv_layer.z);
+    ghost_interp = int(instance_scale_ghost.z);
+}
@@ -0,0 +1,270 @@
+/*
+ * Stress-test benchmark for Strike Fighters
+ *
+ * Boots the game headless (or offscreen with --offscreen), keeps a scripted
+ * number of entities alive, runs a fixed number of simulation ticks and
+ * writes per-phase timings, allocations and frame-time percentiles as JSON
+ *
+ *   strike_bench [--scenario baseline|stress] [--ticks N] [--warmup N]
+ *                [--enemies N] [--projectiles N] [--asteroids N]
+ *                [--missiles N] [--dust N] [--seed N] [--threads N] [--offscreen]
+ *                [--out file.json]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <algorithm>
+
+#include "game.h"
+#include "profiler.h"
+#include "render_stats.h"
+#include "job_system.h"
+
+#ifndef STRIKE_BENCH_REVISION
+#define STRIKE_BENCH_REVISION "unknown"
+#endif
+
+// Every heap allocation of the process is counted, so the report shows what
+// a tick allocates once the world is warmed up
+static std::atomic<unsigned long long> allocation_count_g(0);
+static std::atomic<unsigned long long> allocation_bytes_g(0);
+
+void* operator new(std::size_t size) {
+    allocation_count_g++;
+    allocation_bytes_g += size;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+    // A named load and how long to run it
+    struct Scenario {
+        std::string name;
+        game::Game::StressLoad load;
+        int dust_particles;
+        int ticks;
+        int warmup;
+    };
+
+    Scenario MakeScenario(const std::string& name) {
+        Scenario scenario;
+        scenario.name = name;
+        scenario.dust_particles = 3000;
+        scenario.ticks = 2000;
+        scenario.warmup = 200;
+        if (name == "stress") {
+            scenario.load.projectiles = 10000;
+            scenario.load.enemies = 2000;
+            scenario.load.asteroids = 500;
+            scenario.load.homing_missiles = 50;
+            scenario.dust_particles = 100000;
+        }
+        else if (name != "baseline") {
+            throw std::runtime_error("Unknown scenario " + name + " (expected baseline or stress)");
+        }
+        return scenario;
+    }
+
+    void WriteZone(std::ostream& out, const game::Profiler::ZoneSummary& zone) {
+        out << "{\"name\": \"" << zone.name << "\", \"depth\": " << zone.depth
+            << ", \"min_ms\": " << zone.min << ", \"avg_ms\": " << zone.avg
+            << ", \"p50_ms\": " << zone.p50 << ", \"p90_ms\": " << zone.p90
+            << ", \"p99_ms\": " << zone.p99 << ", \"max_ms\": " << zone.max << "}";
+    }
+
+    int IntArgument(int argc, char* argv[], int& i) {
+        if (i + 1 >= argc) {
+            throw std::runtime_error(std::string("Missing value for ") + argv[i]);
+        }
+        return std::atoi(argv[++i]);
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // The game logs freely to stdout, that output is kept out of the
+    // measurement and the report
+    std::ostringstream discarded;
+    std::streambuf* stdout_buffer = std::cout.rdbuf();
+
+    try {
+        // The scenario comes first so the other options can override it
+        std::string scenario_name = "stress";
+        for (int i = 1; i + 1 < argc; i++) {
+            if (std::strcmp(argv[i], "--scenario") == 0) {
+                scenario_name = argv[i + 1];
+            }
+        }
+        Scenario scenario = MakeScenario(scenario_name);
+
+        bool offscreen = false;
+        bool has_seed = false;
+        uint32_t seed = 1;
+        int thread_count = 0;
+        std::string out_path = "strike_bench.json";
+        for (int i = 1; i < argc; i++) {
+            std::string arg(argv[i]);
+            if (arg == "--scenario") i++;
+            else if (arg == "--ticks") scenario.ticks = IntArgument(argc, argv, i);
+            else if (arg == "--warmup") scenario.warmup = IntArgument(argc, argv, i);
+            else if (arg == "--enemies") scenario.load.enemies = IntArgument(argc, argv, i);
+            else if (arg == "--projectiles") scenario.load.projectiles = IntArgument(argc, argv, i);
+            else if (arg == "--asteroids") scenario.load.asteroids = IntArgument(argc, argv, i);
+            else if (arg == "--missiles") scenario.load.homing_missiles = IntArgument(argc, argv, i);
+            else if (arg == "--dust") scenario.dust_particles = IntArgument(argc, argv, i);
+            else if (arg == "--seed") { seed = static_cast<uint32_t>(IntArgument(argc, argv, i)); has_seed = true; }
+            else if (arg == "--threads") thread_count = IntArgument(argc, argv, i);
+            else if (arg == "--offscreen") offscreen = true;
+            else if (arg == "--out" && i + 1 < argc) out_path = argv[++i];
+            else throw std::runtime_error("Unknown option " + arg);
+        }
+        if (scenario.ticks <= 0) {
+            throw std::runtime_error("--ticks must be positive");
+        }
+
+        game::Game the_game;
+        the_game.SetSeed(has_seed ? seed : 1);
+        // Split the enemies over the three types
+        the_game.SetEnemyLimit(std::max((scenario.load.enemies + 2) / 3, 2));
+        the_game.SetDustParticleCount(scenario.dust_particles);
+        the_game.SetPlayerImmortal(true);
+        the_game.SetThreadCount(thread_count);
+        if (offscreen) {
+            the_game.Init(false);
+        }
+        else {
+            the_game.InitHeadless();
+        }
+
+        std::cout.rdbuf(discarded.rdbuf());
+        the_game.SetupGameWorld();
+        // Time the frames, not the asset streaming
+        the_game.WaitForTextures();
+        for (int i = 0; i < scenario.warmup; i++) {
+            the_game.RunBenchFrame(scenario.load);
+            discarded.str("");
+        }
+
+        // Measure only the ticks after the warm-up
+        game::Profiler::SetHistoryLength(scenario.ticks);
+        unsigned long long allocations_before = allocation_count_g;
+        unsigned long long bytes_before = allocation_bytes_g;
+        int game_over_tick = -1;
+        auto wall_start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < scenario.ticks; tick++) {
+            the_game.RunBenchFrame(scenario.load);
+            if (game_over_tick < 0 && the_game.IsGameOver()) {
+                game_over_tick = tick;
+            }
+            discarded.str("");
+        }
+        double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        unsigned long long allocations = allocation_count_g - allocations_before;
+        unsigned long long bytes = allocation_bytes_g - bytes_before;
+
+        std::cout.rdbuf(stdout_buffer);
+
+        // Report
+        std::vector<game::Profiler::ZoneSummary> zones = game::Profiler::Summarize();
+        const game::EntityRegistry& entities = the_game.GetEntities();
+
+        std::ofstream out(out_path);
+        if (!out) {
+            throw std::runtime_error("Cannot write " + out_path);
+        }
+        out << "{\n";
+        out << "  \"revision\": \"" << STRIKE_BENCH_REVISION << "\",\n";
+        out << "  \"scenario\": \"" << scenario.name << "\",\n";
+        out << "  \"mode\": \"" << (offscreen ? "offscreen" : "headless") << "\",\n";
+        out << "  \"seed\": " << (has_seed ? seed : 1) << ",\n";
+        out << "  \"threads\": " << game::JobSystem::GetThreadCount() << ",\n";
+        out << "  \"ticks\": " << scenario.ticks << ",\n";
+        out << "  \"warmup\": " << scenario.warmup << ",\n";
+        out << "  \"load\": {\"enemies\": " << scenario.load.enemies
+            << ", \"projectiles\": " << scenario.load.projectiles
+            << ", \"asteroids\": " << scenario.load.asteroids
+            << ", \"homing_missiles\": " << scenario.load.homing_missiles
+            << ", \"dust_particles\": " << (offscreen ? scenario.dust_particles : 0) << "},\n";
+        out << "  \"final_entities\": {\"enemies\": " << entities.Enemies().Size()
+            << ", \"projectiles\": " << entities.Projectiles().Size()
+            << ", \"asteroids\": " << entities.Asteroids().Size()
+            << ", \"homing_missiles\": " << entities.HomingMissiles().Size()
+            << ", \"total\": " << entities.Count() << "},\n";
+        out << "  \"game_over_tick\": " << game_over_tick << ",\n";
+        out << "  \"wall_seconds\": " << wall_seconds << ",\n";
+        out << "  \"allocations\": {\"count\": " << allocations << ", \"bytes\": " << bytes
+            << ", \"per_tick\": " << static_cast<double>(allocations) / scenario.ticks << "},\n";
+        out << "  \"frame\": ";
+        for (const game::Profiler::ZoneSummary& zone : zones) {
+            if (std::strcmp(zone.name, "Frame") == 0) {
+                WriteZone(out, zone);
+            }
+        }
+        out << ",\n  \"phases\": [\n";
+        for (size_t i = 0; i < zones.size(); i++) {
+            out << "    ";
+            WriteZone(out, zones[i]);
+            out << (i + 1 < zones.size() ? ",\n" : "\n");
+        }
+        out << "  ]";
+        if (offscreen) {
+            out << ",\n  \"gpu_passes\": [\n";
+            for (int i = 0; i < static_cast<int>(game::RenderPass::PASS_COUNT); i++) {
+                game::RenderPass pass = static_cast<game::RenderPass>(i);
+                const game::RenderStats::PassStats& stats = game::RenderStats::GetPass(pass);
+                out << "    {\"name\": \"" << game::RenderStats::GetPassName(pass) << "\", \"gpu_ms\": " << stats.gpu_ms
+                    << ", \"draws\": " << stats.draws << ", \"shader_switches\": " << stats.shader_switches
+                    << ", \"texture_binds\": " << stats.texture_binds << ", \"uniform_uploads\": " << stats.uniform_uploads
+                    << "}" << (i + 1 < static_cast<int>(game::RenderPass::PASS_COUNT) ? ",\n" : "\n");
+            }
+            out << "  ]";
+        }
+        out << "\n}\n";
+        out.close();
+
+        std::cout << "Scenario " << scenario.name << ": " << scenario.ticks << " ticks in " << wall_seconds
+            << " s, " << allocations << " allocations, report written to " << out_path << std::endl;
+        game::Profiler::PrintTable(std::cout);
+        the_game.PrintPoolStats(std::cout);
+
+        // The game's own exit report is not part of the benchmark
+        std::cout.rdbuf(discarded.rdbuf());
+    }
+    catch (std::exception& e) {
+        std::cout.rdbuf(stdout_buffer);
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    std::cout.rdbuf(stdout_buffer);
+    return 0;
+}
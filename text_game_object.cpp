@@ -1,4 +1,5 @@
 #include "text_game_object.h"
+#include "render_stats.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 
@@ -8,6 +9,11 @@ namespace game {
     TextGameObject::TextGameObject(const glm::vec3& position, Geometry* geom, Shader* shader, GLuint texture)
         : GameObject(position, geom, shader, texture) {
         text_ = "";
+        text_len_id_ = shader->GetUniformId("text_len");
+        text_content_id_ = shader->GetUniformId("text_content");
+
+        // Glyph edges are blended, but text still claims its pixels
+        render_state_ = RenderState::Blended();
     }
 
     std::string TextGameObject::GetText(void) const {
@@ -41,10 +47,6 @@ namespace game {
             std::cerr << "WARNING: Text too long, truncating: " << text_ << std::endl;
         }
 
-        // Ensure proper blending
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
         // Safety checks with detailed errors
         if (!geometry_) {
             std::cerr << "ERROR: TextGameObject - geometry is null" << std::endl;
@@ -62,32 +64,34 @@ namespace game {
         shader_->Enable();
 
         // Set up the view matrix
-        shader_->SetUniformMat4("view_matrix", view_matrix);
+        shader_->SetUniformMat4(view_matrix_id_, view_matrix);
 
         // Setup the scaling matrix for the shader (increased scale)
         glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(xscale_ * 3.0f, yscale_ * 3.0f, 1.0f));
 
         // Setup the rotation matrix for the shader
-        glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), angle_, glm::vec3(0.0, 0.0, 1.0));
+        glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0f), render_angle_, glm::vec3(0.0, 0.0, 1.0));
 
         // Set up the translation matrix for the shader
-        glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
+        glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), render_position_);
 
         // Setup the transformation matrix for the shader
         glm::mat4 transformation_matrix = translation_matrix * rotation_matrix * scaling_matrix;
 
         // Set the transformation matrix in the shader
-        shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-        shader_->SetUniform1i("ghost_mode", 0);
+        shader_->SetUniformMat4(transformation_matrix_id_, transformation_matrix);
+        shader_->SetUniform1i(ghost_mode_id_, 0);
 
-        // Set up the geometry
+        // Set up the geometry and blending
         geometry_->SetGeometry(shader_->GetShaderProgram());
+        render_state_.Apply();
 
         // Bind the entity's texture
         glBindTexture(GL_TEXTURE_2D, texture_);
+        RenderStats::CountTextureBind();
 
         int final_size = std::min((int)text_.size(), TEXT_LENGTH);
-        shader_->SetUniform1i("text_len", final_size);
+        shader_->SetUniform1i(text_len_id_, final_size);
 
         // Set the text data - initialize all with zeros
         GLint data[TEXT_LENGTH] = { 0 };
@@ -98,7 +102,7 @@ namespace game {
 
         // IMPORTANT: Always pass TEXT_LENGTH as the count to match shader's uniform array size
         try {
-            shader_->SetUniformIntArray("text_content", TEXT_LENGTH, data);
+            shader_->SetUniformIntArray(text_content_id_, TEXT_LENGTH, data);
         }
         catch (const std::exception& e) {
             std::cerr << "Error setting text uniform array: " << e.what() << std::endl;
@@ -106,8 +110,8 @@ namespace game {
 
         // Draw the entity
         glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
+        RenderStats::CountDraw();
 
         shader_->Disable();
-        glDisable(GL_BLEND);
     }
 } // namespace game
\ No newline at end of file
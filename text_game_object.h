@@ -27,6 +27,13 @@ namespace game {
 
         // Render function for the text
         void Render(glm::mat4 view_matrix, double current_time) override;
+        // Text is drawn glyph by glyph with the text shader
+        bool Submit(SpriteBatch& batch) override { return false; }
+
+    protected:
+        // Uniforms of the text shader
+        UniformId text_len_id_;
+        UniformId text_content_id_;
 
     private:
         std::string text_;
@@ -0,0 +1,174 @@
+#include <iostream>
+#include <chrono>
+#include <SOIL/SOIL.h>
+
+#include "texture_loader.h"
+
+namespace game {
+
+    // SOIL keeps its error string and decoder state in globals, so only one
+    // thread may be inside it at a time, even with several loaders
+    static std::mutex soil_mutex_g;
+
+    TextureLoader::TextureLoader(void) : uploaded_(0), sprite_array_(nullptr) {
+    }
+
+
+    TextureLoader::~TextureLoader() {
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+
+        // Images that were decoded but never uploaded
+        for (Request& request : requests_) {
+            if (request.image) {
+                SOIL_free_image_data(request.image);
+            }
+        }
+    }
+
+
+    GLuint TextureLoader::Load(const std::string& path, bool repeat, bool pack) {
+        std::map<std::string, size_t>::const_iterator found = request_index_.find(path);
+        if (found != request_index_.end()) {
+            if (pack && sprite_array_) {
+                sprite_array_->Reserve(requests_[found->second].texture);
+            }
+            return requests_[found->second].texture;
+        }
+
+        Request request;
+        request.path = path;
+        request.repeat = repeat;
+        request.image = nullptr;
+        request.width = 0;
+        request.height = 0;
+        glGenTextures(1, &request.texture);
+
+        // Draw nothing until the real image arrives
+        const unsigned char transparent[4] = { 0, 0, 0, 0 };
+        glBindTexture(GL_TEXTURE_2D, request.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, transparent);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        if (pack && sprite_array_) {
+            sprite_array_->Reserve(request.texture);
+        }
+
+        request_index_[path] = requests_.size();
+        requests_.push_back(request);
+        return request.texture;
+    }
+
+
+    void TextureLoader::Start(void) {
+        if (!requests_.empty()) {
+            worker_ = std::thread(&TextureLoader::DecodeMain, this);
+        }
+    }
+
+
+    void TextureLoader::DecodeMain(void) {
+        for (size_t index = 0; index < requests_.size(); index++) {
+            // Only this thread writes the request until it is queued
+            Request& request = requests_[index];
+            {
+                std::lock_guard<std::mutex> lock(soil_mutex_g);
+                request.image = SOIL_load_image(request.path.c_str(), &request.width, &request.height, 0, SOIL_LOAD_RGBA);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(decoded_mutex_);
+                decoded_.push_back(index);
+            }
+            decoded_ready_.notify_one();
+        }
+    }
+
+
+    int TextureLoader::Upload(double budget_ms) {
+        auto start = std::chrono::steady_clock::now();
+        int uploaded = 0;
+        while (true) {
+            size_t index;
+            {
+                std::lock_guard<std::mutex> lock(decoded_mutex_);
+                if (decoded_.empty()) {
+                    break;
+                }
+                index = decoded_.front();
+                decoded_.pop_front();
+            }
+            UploadRequest(requests_[index]);
+            uploaded++;
+
+            // Mipmaps once, after the last layer is filled
+            if (IsDone() && sprite_array_) {
+                sprite_array_->GenerateMipmaps();
+            }
+
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed.count() >= budget_ms) {
+                break;
+            }
+        }
+        return uploaded;
+    }
+
+
+    void TextureLoader::Finish(void) {
+        while (!IsDone()) {
+            {
+                std::unique_lock<std::mutex> lock(decoded_mutex_);
+                decoded_ready_.wait(lock, [this] { return !decoded_.empty(); });
+            }
+            Upload(1.0e9);
+        }
+    }
+
+
+    void TextureLoader::UploadRequest(Request& request) {
+        uploaded_++;
+        if (!request.image) {
+            // The placeholder stays
+            std::cout << "Cannot load texture " << request.path << std::endl;
+            return;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, request.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, request.width, request.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, request.image);
+        if (sprite_array_ && sprite_array_->GetLayer(request.texture) >= 0 &&
+            !sprite_array_->SetImage(request.texture, request.image, request.width, request.height)) {
+            std::cout << "Texture " << request.path << " is larger than a sprite array layer" << std::endl;
+        }
+        SOIL_free_image_data(request.image);
+        request.image = nullptr;
+
+        if (request.repeat) {
+            // Enable texture tiling/wrapping for the background
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        }
+        else {
+            // Default texture wrapping for other textures
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
+        // Texture Filtering
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+
+    void TextureLoader::Release(void) {
+        for (Request& request : requests_) {
+            if (request.texture) {
+                glDeleteTextures(1, &request.texture);
+                request.texture = 0;
+            }
+        }
+    }
+
+} // namespace game
@@ -0,0 +1,95 @@
+#ifndef TEXTURE_LOADER_H_
+#define TEXTURE_LOADER_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "sprite_array.h"
+
+namespace game {
+
+    // Loads texture files in the background
+    // Load() hands out a texture name right away, holding a transparent
+    // placeholder; Start() decodes the files on a worker thread, and Upload(),
+    // called once per frame on the GL thread, moves the decoded images to
+    // the GPU a few at a time, so frames keep coming while assets stream in
+    // A file requested twice is decoded once and shares one texture
+    // Files loaded with pack set are also copied into a SpriteArray layer,
+    // whose mipmaps are built once the last texture is in
+    class TextureLoader {
+
+    public:
+        TextureLoader(void);
+        ~TextureLoader();
+
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
+
+        // Array that receives the packed sprites, call before Load()
+        inline void SetSpriteArray(SpriteArray* sprite_array) { sprite_array_ = sprite_array; }
+
+        // Texture for an image file, call before Start()
+        // repeat tiles the texture instead of clamping it at the edges,
+        // pack also gives it a layer in the sprite array
+        GLuint Load(const std::string& path, bool repeat = false, bool pack = false);
+
+        // Decode every requested file on one background thread
+        // SOIL is not reentrant, so more threads would only wait on each other
+        void Start(void);
+
+        // Upload decoded images until budget_ms has passed, at least one if
+        // any is ready; returns the number uploaded
+        int Upload(double budget_ms);
+
+        // Block until every requested texture is uploaded
+        void Finish(void);
+
+        // True once every requested texture is on the GPU
+        inline bool IsDone(void) const { return uploaded_ == requests_.size(); }
+        inline size_t GetRequestCount(void) const { return requests_.size(); }
+        inline size_t GetUploadedCount(void) const { return uploaded_; }
+
+        // Delete every texture, call while the GL context still exists
+        void Release(void);
+
+    private:
+        // One file, decoded by a worker and uploaded by the GL thread
+        struct Request {
+            std::string path;
+            GLuint texture;
+            bool repeat;
+            unsigned char* image;   // Decoded RGBA pixels, nullptr if decoding failed
+            int width;
+            int height;
+        };
+
+        // Decode requests until none are left
+        void DecodeMain(void);
+
+        // Fill a request's texture with its decoded image
+        void UploadRequest(Request& request);
+
+        std::vector<Request> requests_;
+        std::map<std::string, size_t> request_index_;   // Request of each path
+        size_t uploaded_;
+        SpriteArray* sprite_array_;
+
+        std::thread worker_;                            // Decodes the requests in order
+
+        // Requests decoded but not uploaded yet
+        std::mutex decoded_mutex_;
+        std::condition_variable decoded_ready_;
+        std::deque<size_t> decoded_;
+
+    }; // class TextureLoader
+
+} // namespace game
+
+#endif // TEXTURE_LOADER_H_
@@ -1,5 +1,5 @@
-#include <GLFW/glfw3.h>
 #include "timer.h"
+#include "game_clock.h"
 
 namespace game {
 
@@ -10,14 +10,14 @@ namespace game {
     }
 
     void Timer::Start(float end_time) {
-        start_time_ = glfwGetTime();
+        start_time_ = GameClock::Now();
         end_time_ = start_time_ + end_time;
         running_ = true;
     }
 
     bool Timer::Finished(void) const {
         if (!running_) return false;
-        return glfwGetTime() >= end_time_;
+        return GameClock::Now() >= end_time_;
     }
 
 } // namespace game
\ No newline at end of file
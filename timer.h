@@ -5,6 +5,7 @@
 namespace game {
 
     // A class implementing a simple timer
+    // Measures game time (GameClock), so it stops while the game is paused
     class Timer {
     public:
         // Constructor and destructor
@@ -0,0 +1,89 @@
+#include <cmath>
+
+#include "timer_wheel.h"
+
+namespace game {
+
+    TimerWheel::TimerWheel(double tick_seconds, size_t slot_count)
+        : tick_seconds_(tick_seconds), current_tick_(0), next_id_(1), slots_(slot_count) {
+    }
+
+
+    TimerWheel::TimerId TimerWheel::Schedule(double now, double delay, std::function<void()> callback) {
+        // Round up so an event never runs early, and never on a tick already processed
+        uint64_t due_tick = static_cast<uint64_t>(std::ceil((now + delay) / tick_seconds_));
+        if (due_tick <= current_tick_) {
+            due_tick = current_tick_ + 1;
+        }
+
+        TimerId id = next_id_++;
+        slots_[due_tick % slots_.size()].push_back({ id, due_tick, std::move(callback) });
+        due_ticks_[id] = due_tick;
+        return id;
+    }
+
+
+    bool TimerWheel::Cancel(TimerId id) {
+        auto it = due_ticks_.find(id);
+        if (it == due_ticks_.end()) {
+            return false;
+        }
+
+        std::vector<Event>& slot = slots_[it->second % slots_.size()];
+        for (size_t i = 0; i < slot.size(); i++) {
+            if (slot[i].id == id) {
+                slot.erase(slot.begin() + i);
+                break;
+            }
+        }
+        due_ticks_.erase(it);
+        return true;
+    }
+
+
+    void TimerWheel::Advance(double now) {
+        uint64_t target_tick = static_cast<uint64_t>(std::floor(now / tick_seconds_));
+
+        while (current_tick_ < target_tick) {
+            // Nothing is pending, skip straight to the target
+            if (due_ticks_.empty()) {
+                current_tick_ = target_tick;
+                break;
+            }
+            current_tick_++;
+
+            // Take this tick's events out first, callbacks may add to the slot
+            std::vector<Event>& slot = slots_[current_tick_ % slots_.size()];
+            firing_.clear();
+            for (size_t i = 0; i < slot.size();) {
+                if (slot[i].due_tick == current_tick_) {
+                    firing_.push_back(std::move(slot[i]));
+                    slot.erase(slot.begin() + i);
+                }
+                else {
+                    i++;
+                }
+            }
+
+            for (size_t i = 0; i < firing_.size(); i++) {
+                // An earlier callback this tick may have cancelled it
+                if (due_ticks_.erase(firing_[i].id) == 0) {
+                    continue;
+                }
+                std::function<void()> callback = std::move(firing_[i].callback);
+                callback();
+            }
+        }
+    }
+
+
+    void TimerWheel::Clear(void) {
+        for (std::vector<Event>& slot : slots_) {
+            slot.clear();
+        }
+        due_ticks_.clear();
+        firing_.clear();
+        current_tick_ = 0;
+    }
+
+} // namespace game
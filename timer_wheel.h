@@ -0,0 +1,55 @@
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace game {
+
+    // Runs callbacks at a future game time
+    // Events are hashed into slots by the tick they are due on. Advancing the
+    // wheel only visits the slots it passes over, so a pending event costs
+    // nothing until its tick comes round
+    class TimerWheel {
+    public:
+        typedef uint64_t TimerId;  // 0 is never a valid id
+
+        TimerWheel(double tick_seconds = 1.0 / 120.0, size_t slot_count = 256);
+
+        // Run callback once delay seconds after now, returns an id for Cancel()
+        TimerId Schedule(double now, double delay, std::function<void()> callback);
+
+        // Drop a pending event, returns false if it already ran or was cancelled
+        bool Cancel(TimerId id);
+
+        // Run every event due by now, in the order they fall due
+        // Callbacks may schedule and cancel events
+        void Advance(double now);
+
+        // Drop every pending event and restart at time 0
+        void Clear(void);
+
+        inline size_t GetPendingCount(void) const { return due_ticks_.size(); }
+
+    private:
+        struct Event {
+            TimerId id;
+            uint64_t due_tick;
+            std::function<void()> callback;
+        };
+
+        double tick_seconds_;
+        uint64_t current_tick_;               // Last tick processed
+        TimerId next_id_;
+        std::vector<std::vector<Event>> slots_;
+        std::unordered_map<TimerId, uint64_t> due_ticks_;  // Pending events
+        std::vector<Event> firing_;           // Events due on the current tick
+
+    }; // class TimerWheel
+
+} // namespace game
+
+#endif // TIMER_WHEEL_H_